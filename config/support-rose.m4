@@ -241,6 +241,19 @@ if test "x$enable_memory_pool_no_reuse" = "xyes"; then
   AC_DEFINE([ROSE_USE_MEMORY_POOL_NO_REUSE], [], [Whether to use a special no-reuse mode of memory pools])
 fi
 
+# ************************************************************
+# Option to give each thread its own free list within the IR node memory pools so that the ROSETTA-generated new and
+# delete operators don't serialize on a per-class mutex when ASTs are built or copied by several threads.  Requires
+# __thread support (ROSE_THREAD_LOCAL_STORAGE) and that the user compiles with -pthread.
+# ************************************************************
+
+AC_ARG_ENABLE(thread-local-memory-pools, AS_HELP_STRING([--enable-thread-local-memory-pools], [Enable per-thread free lists in the IR node memory pools (default is one mutex-protected free list per IR node type)]))
+AM_CONDITIONAL(ROSE_USE_THREAD_LOCAL_MEMORY_POOLS, [test "x$enable_thread_local_memory_pools" = xyes])
+if test "x$enable_thread_local_memory_pools" = "xyes"; then
+  AC_MSG_NOTICE([using thread-local free lists in IR node memory pools])
+  AC_DEFINE([ROSE_USE_THREAD_LOCAL_MEMORY_POOLS], [], [Whether IR node memory pools use per-thread free lists])
+fi
+
 
 # ************************************************************
 # Option to control the size of the generated files by ROSETTA
@@ -607,6 +607,59 @@ struct FuncAnalysis {
 
 typedef std::map<int/*func_id*/, FuncAnalysis> FuncAnalyses;
 
+// See Schema.sql for semantic_funcpartials
+struct FuncPartialsRow {
+    int func_id;
+    FuncAnalysis info;
+
+    FuncPartialsRow(int func_id, const FuncAnalysis &info): func_id(func_id), info(info) {}
+    void serialize(std::ostream &stream) const { // output order must match the schema
+        stream <<func_id <<"," <<info.ncalls <<"," <<info.nretused <<"," <<info.ntests <<"," <<info.nvoids <<"\n";
+    }
+};
+
+/*******************************************************************************************************************************
+ *                                      Test results
+ *******************************************************************************************************************************/
+
+/** Results of one test.  See Schema.sql for semantic_fio. */
+struct FioRow {
+    int func_id;                                /**< ID of function that was tested. */
+    int igroup_id;                              /**< ID of input group that was used. */
+    size_t arguments_consumed;                  /**< Inputs consumed for arguments, etc. */
+    size_t locals_consumed;
+    size_t globals_consumed;
+    size_t functions_consumed;
+    size_t pointers_consumed;
+    size_t integers_consumed;
+    size_t instructions_executed;               /**< Number of instructions executed by the test. */
+    int64_t ogroup_id;                          /**< Output group, or negative if not known yet. */
+    std::string counts_b64;                     /**< Compressed syntactic signature vector, base64 encoded. */
+    int syntactic_ninsns;                       /**< Number of instructions in the syntactic signature. */
+    int status;                                 /**< Exit status, an AnalysisFault::Fault. */
+    double elapsed_time;                        /**< Seconds elapsed, excluding pointer analysis. */
+    double cpu_time;                            /**< CPU seconds used by the thread, excluding pointer analysis. */
+    int64_t cmd;                                /**< Command that ran the test. */
+
+    FioRow()
+        : func_id(-1), igroup_id(-1), arguments_consumed(0), locals_consumed(0), globals_consumed(0), functions_consumed(0),
+          pointers_consumed(0), integers_consumed(0), instructions_executed(0), ogroup_id(-1), syntactic_ninsns(0),
+          status(0), elapsed_time(0.0), cpu_time(0.0), cmd(-1) {}
+
+    void serialize(std::ostream &stream) const { // output order must match the schema; instr_seq_b64 is always null
+        stream <<func_id <<"," <<igroup_id <<","
+               <<arguments_consumed <<"," <<locals_consumed <<"," <<globals_consumed <<"," <<functions_consumed <<","
+               <<pointers_consumed <<"," <<integers_consumed <<"," <<instructions_executed <<"," <<ogroup_id <<","
+               <<counts_b64 <<"," <<syntactic_ninsns <<",," <<status <<"," <<elapsed_time <<"," <<cpu_time <<"," <<cmd <<"\n";
+    }
+};
+
+/** Test results waiting to be saved in the semantic_fio table. */
+class FioTable: public WriteOnlyTable<FioRow> {
+public:
+    FioTable(): WriteOnlyTable<FioRow>("semantic_fio") {}
+};
+
 /*******************************************************************************************************************************
  *                                      Output groups
  *******************************************************************************************************************************/
@@ -19,7 +19,7 @@ enum PathSyntactic {PATH_SYNTACTIC_NONE, PATH_SYNTACTIC_ALL, PATH_SYNTACTIC_FUNC
 struct Switches {
     Switches()
         : verbosity(SILENT), progress(false), pointers(false), interactive(false), trace_events(0), dry_run(false),
-          save_coverage(false), save_callgraph(false), save_consumed_inputs(false), nprocs(1),
+          save_coverage(false), save_callgraph(false), save_consumed_inputs(false), nprocs(1), nthreads(1),
           path_syntactic(PATH_SYNTACTIC_NONE) {
         checkpoint = 300 + LinearCongruentialGenerator()()%600;
     }
@@ -36,6 +36,7 @@ struct Switches {
     bool save_consumed_inputs;
     PolicyParams params;                                // parameters controlling instruction semantics
     size_t nprocs;                                      // number of parallel processes to fork
+    size_t nthreads;                                    // number of threads running tests; zero means one per processor
     std::vector<std::string> signature_components;      /**< How should the signature vectors be computed */
     PathSyntactic path_syntactic;                       /**< How to compute path sensistive syntactic signature */
 };
@@ -54,6 +55,34 @@ typedef std::vector<WorkItem> Work;
 typedef std::vector<Work> MultiWork;
 typedef std::map<SgAsmFunction*, PointerDetector*> PointerDetectors;
 
+/** Data accumulated by tests until the next checkpoint.  Each thread that runs tests has its own. */
+struct TestOutputs {
+    Tracer tracer;
+    InsnCoverage insn_coverage;
+    DynamicCallGraph dynamic_cg;
+    ConsumedInputs consumed_inputs;
+    FuncAnalyses funcinfo;
+};
+
+typedef std::vector<TestOutputs*> TestOutputsList;
+
+/** A test whose function, pointer analysis, and input group are ready. */
+struct ReadyTest {
+    WorkItem workItem;
+    SgAsmFunction *func;
+    const PointerDetector *pointers;
+    const InputGroup *igroup;                           // each test runs with its own copy
+    ReadyTest(): func(NULL), pointers(NULL), igroup(NULL) {}
+    ReadyTest(const WorkItem &workItem, SgAsmFunction *func, const PointerDetector *pointers, const InputGroup *igroup)
+        : workItem(workItem), func(func), pointers(pointers), igroup(igroup) {}
+};
+
+/** Results of one test that have not been saved yet. The output group ID is assigned when the result is saved. */
+struct TestResult {
+    OutputGroup ogroup;
+    FioRow fio;
+};
+
 extern Switches opt;
 extern std::string argv0;
 extern int interrupted;
@@ -62,6 +91,8 @@ void usage(int exit_status);
 int parse_commandline(int argc, char *argv[]);
 Work load_work(const std::string &filename, FILE*);
 CloneDetection::PointerDetector* detect_pointers(SgAsmFunction*, const CloneDetection::FunctionIdMap&);
+const CloneDetection::PointerDetector* pointer_detector(PointerDetectors&, SgAsmFunction*,
+                                                        const CloneDetection::FunctionIdMap&);
 void sig_handler(int signo);
 void add_builtin_functions(NameSet&);
 SgAsmGenericHeader* header_for_va(SgAsmInterpretation*, rose_addr_t va);
@@ -74,15 +105,18 @@ OutputGroup fuzz_test(SgAsmInterpretation *interp, SgAsmFunction *function, Inpu
                       const AddressIdMap &entry2id, const rose::BinaryAnalysis::Disassembler::AddressSet &whitelist_exports,
                       FuncAnalyses &funcinfo, InsnCoverage &insn_coverage, DynamicCallGraph &dynamic_cg,
                       ConsumedInputs &consumed_inputs);
-SqlDatabase::TransactionPtr checkpoint(const SqlDatabase::TransactionPtr &tx, OutputGroups &ogroups, Tracer &tracer,
-                                       InsnCoverage &insn_coverage, DynamicCallGraph &dynamic_cg, ConsumedInputs &consumed_inputs,
-                                       Progress *progress, size_t ntests_ran, int64_t cmd_id);
-void runOneTest(SqlDatabase::TransactionPtr tx, const WorkItem &workItem, PointerDetectors &pointers, SgAsmFunction *func,
-                const FunctionIdMap &function_ids, InsnCoverage &insn_coverage /*in,out*/, DynamicCallGraph &dynamic_cg /*in,out*/,
-                Tracer &tracer /*in,out*/, ConsumedInputs &consumed_inputs /*in,out*/, SgAsmInterpretation *interp,
-                const rose::BinaryAnalysis::Disassembler::AddressSet &whitelist_exports, int64_t cmd_id, InputGroup &igroup,
-                FuncAnalyses funcinfo, const InstructionProvidor &insns, MemoryMap *ro_map, const AddressIdMap &entry2id,
-                OutputGroups &ogroups /*in,out*/);
+SqlDatabase::TransactionPtr checkpoint(const SqlDatabase::TransactionPtr &tx, OutputGroups &ogroups, FioTable &fio,
+                                       const TestOutputsList &outputs, Progress *progress, size_t ntests_ran, int64_t cmd_id);
+void saveFuncPartials(const SqlDatabase::TransactionPtr &tx, const TestOutputsList &outputs);
+TestResult runOneTest(const WorkItem &workItem, SgAsmFunction *func, const PointerDetector *pointers,
+                      TestOutputs &outputs /*in,out*/, SgAsmInterpretation *interp,
+                      const rose::BinaryAnalysis::Disassembler::AddressSet &whitelist_exports, int64_t cmd_id,
+                      InputGroup &igroup, const InstructionProvidor &insns, MemoryMap *ro_map, const AddressIdMap &entry2id);
+void runTests(const std::vector<ReadyTest> &tests, const TestOutputsList &outputs /*in,out*/, SgAsmInterpretation *interp,
+              const rose::BinaryAnalysis::Disassembler::AddressSet &whitelist_exports, int64_t cmd_id,
+              const InstructionProvidor &insns, MemoryMap *ro_map, const AddressIdMap &entry2id,
+              std::vector<TestResult> &results /*out*/);
+void saveTestResult(const TestResult&, OutputGroups &ogroups /*in,out*/, FioTable &fio /*in,out*/);
 
 } // namespace
 } // namespace
@@ -25,6 +25,7 @@
 #include "ExprAnalyzer.h"
 #include "StateRepresentations.h"
 #include "PropertyValueTable.h"
+#include "WorkListWorkStealing.h"
 
 // we use INT_MIN, INT_MAX
 #include "limits.h"
@@ -332,6 +333,9 @@ namespace CodeThorn {
     void setMaxIterationsForcedTop(size_t maxIterations) { _maxIterationsForcedTop=maxIterations; }
     void eventGlobalTopifyTurnedOn();
     void setMinimizeStates(bool minimizeStates) { _minimizeStates=minimizeStates; }
+    //! solver 5 uses per-thread work lists with work stealing instead of the shared work list
+    void setWorkStealing(bool workStealing) { _workStealing=workStealing; }
+    bool getWorkStealing() { return _workStealing; }
     bool isIncompleteSTGReady();
     bool isPrecise();
     PropertyValueTable reachabilityResults;
@@ -400,6 +404,9 @@ namespace CodeThorn {
     int _approximated_iterations;
     int _curr_iteration_cnt;
     int _next_iteration_cnt;
+    bool _workStealing;
+    // non-null while solver 5 runs with work stealing; then used by all work list functions instead of estateWorkList
+    WorkListWorkStealing<const EState*>* _workStealingWorkList;
   }; // end of class Analyzer
   
 } // end of namespace CodeThorn
@@ -408,7 +415,7 @@ namespace CodeThorn {
 #ifdef RERS_SPECIALIZATION
 // RERS-binary-binding-specific declarations
 #define STR_VALUE(arg) #arg
-#define COPY_PSTATEVAR_TO_GLOBALVAR(VARNAME) VARNAME[thread_id] = pstate[analyzer->globalVarIdByName(STR_VALUE(VARNAME))].getValue().getIntValue();
+#define COPY_PSTATEVAR_TO_GLOBALVAR(VARNAME) VARNAME[thread_id] = pstate.varValue(analyzer->globalVarIdByName(STR_VALUE(VARNAME))).getIntValue();
 
 //cout<<"PSTATEVAR:"<<pstate[analyzer->globalVarIdByName(STR_VALUE(VARNAME))].toString()<<"="<<pstate[analyzer->globalVarIdByName(STR_VALUE(VARNAME))].getValue().toString()<<endl;
 
@@ -6,126 +6,125 @@
  * Author   : Markus Schordan                                *
  * License  : see file LICENSE in the CodeThorn distribution *
  *************************************************************/
-//#define USE_CUSTOM_HSET
-#ifdef USE_CUSTOM_HSET
-#include "HSet.h"
-using namespace br_stl;
-#else
 #include <boost/unordered_set.hpp>
+#include <iterator>
+#include <stdint.h>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
 #endif
 
 //#include "/usr/include/valgrind/memcheck.h"
 //#define HSET_MAINTAINER_DEBUG_MODE
 
-/*! 
+// number of shards of each HSetMaintainer (must be a power of two)
+#ifndef HSET_MAINTAINER_SHARDS
+#define HSET_MAINTAINER_SHARDS 64
+#endif
+
+/*!
   * \author Markus Schordan
   * \date 2012.
+
+  The elements are distributed over HSET_MAINTAINER_SHARDS hash sets
+  (shards) by their hash value. Each shard has its own lock, such that
+  threads that process elements of different shards do not wait for each
+  other. Lookups and insertions (determine, process, processNew,
+  processNewOrExisting) are thread safe. Iterating, erasing, and the
+  statistics functions must not run concurrently with insertions.
  */
 template<typename KeyType,typename HashFun, typename EqualToPred>
-class HSetMaintainer 
-#ifdef USE_CUSTOM_HSET
-  : public HSet<KeyType*,HashFun,EqualToPred>
-#else
-  : public boost::unordered_set<KeyType*,HashFun,EqualToPred>
-#endif
-  {
-public:
+class HSetMaintainer {
+ public:
+  typedef boost::unordered_set<KeyType*,HashFun,EqualToPred> Shard;
   typedef pair<bool,const KeyType*> ProcessingResult;
-  bool exists(KeyType& s) { 
+
+  //! iterates over all shards; the elements of a set are immutable, therefore iterator and const_iterator are the same type
+  class const_iterator : public std::iterator<std::forward_iterator_tag, KeyType*> {
+  public:
+    const_iterator():_shards(0),_shard(0) {}
+    const_iterator(const std::vector<Shard>* shards, size_t shard, typename Shard::const_iterator pos)
+      :_shards(shards),_shard(shard),_pos(pos) {
+      skipEmptyShards();
+    }
+    KeyType* const& operator*() const { return *_pos; }
+    KeyType* const* operator->() const { return &*_pos; }
+    const_iterator& operator++() {
+      ++_pos;
+      skipEmptyShards();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator old=*this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const const_iterator& other) const {
+      return _shard==other._shard && (!_shards || _shard==_shards->size() || _pos==other._pos);
+    }
+    bool operator!=(const const_iterator& other) const { return !(*this==other); }
+    size_t shard() const { return _shard; }
+    typename Shard::const_iterator position() const { return _pos; }
+  private:
+    // moves to the first element of the next non-empty shard if the end of the current shard is reached
+    void skipEmptyShards() {
+      while(_shard<_shards->size() && _pos==(*_shards)[_shard].end()) {
+        if(++_shard<_shards->size())
+          _pos=(*_shards)[_shard].begin();
+      }
+    }
+    const std::vector<Shard>* _shards;
+    size_t _shard;
+    typename Shard::const_iterator _pos;
+  };
+  typedef const_iterator iterator;
+
+  HSetMaintainer():_shards(HSET_MAINTAINER_SHARDS) {
+    initLocks();
+  }
+  HSetMaintainer(const HSetMaintainer& other):_shards(other._shards) {
+    initLocks();
+  }
+  HSetMaintainer& operator=(const HSetMaintainer& other) {
+    _shards=other._shards;
+    return *this;
+  }
+  ~HSetMaintainer() {
+#ifdef _OPENMP
+    for(size_t i=0;i<_locks.size();++i)
+      omp_destroy_lock(&_locks[i]);
+#endif
+  }
+
+  bool exists(KeyType& s) {
     return determine(s)!=0;
   }
 
   size_t id(const KeyType& s) {
-#ifdef USE_CUSTOM_HSET
-    typename HSet<KeyType*,HashFun,EqualToPred>::const_iterator i;
-#else
-    typename boost::unordered_set<KeyType*,HashFun,EqualToPred>::const_iterator i;
-#endif
-    i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(s);
-    if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
+    const_iterator i=find(const_cast<KeyType*>(&s));
+    if(i!=end()) {
       // in lack of operator '-' we compute the distance
       size_t pos=0;
-#ifdef USE_CUSTOM_HSET
-      typename HSet<KeyType*,HashFun,EqualToPred>::const_iterator b;
-#else
-      typename boost::unordered_set<KeyType*,HashFun,EqualToPred>::const_iterator b;
-#endif
-      b=HSetMaintainer<KeyType,HashFun,EqualToPred>::begin();
-      while(b!=i) {
+      for(const_iterator b=begin();b!=i;++b)
         pos++;
-        ++b;
-      }
       return pos;
     }
     else
       throw "Error: unknown value. Maintainer cannot determine an id.";
   }
 
-  typename HSetMaintainer<KeyType,HashFun,EqualToPred>::iterator i;
-
-  KeyType* determine(KeyType& s) { 
-    KeyType* ret=0;
-    typename HSetMaintainer<KeyType,HashFun,EqualToPred>::iterator i;
-#pragma omp critical(HASHSET)
-    {
-#ifdef USE_CUSTOM_HSET
-      i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(s);
-      if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
-        ret=const_cast<KeyType*>(&(*i));
-      } else {
-        ret=0;
-      }
-#else
-      i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(&s);
-      if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
-        ret=const_cast<KeyType*>(*i);
-      } else {
-        ret=0;
-      }
-#endif
-    }
-    return ret;
+  KeyType* determine(KeyType& s) {
+    return const_cast<KeyType*>(lookup(&s,shardOf(&s)));
   }
 
-  const KeyType* determine(const KeyType& s) { 
-    const KeyType* ret=0;
-    typename HSetMaintainer<KeyType,HashFun,EqualToPred>::iterator i;
-#pragma omp critical(HASHSET)
-    {
-#ifdef USE_CUSTOM_HSET
-      i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(s);
-      if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
-        ret=&(*i);
-      } else {
-        ret=0;
-      }
-#else
-      i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(const_cast<KeyType*>(&s));
-      if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
-        ret=const_cast<KeyType*>(*i);
-      } else {
-        ret=0;
-      }
-#endif
-    }
-    return ret;
+  const KeyType* determine(const KeyType& s) {
+    KeyType* key=const_cast<KeyType*>(&s);
+    return lookup(key,shardOf(key));
   }
 
   ProcessingResult process(const KeyType* key) {
-    ProcessingResult res2;
-#pragma omp critical(HASHSET)
-    {
-      std::pair<typename HSetMaintainer::iterator, bool> res;
-      typename HSetMaintainer::iterator iter=this->find(const_cast<KeyType*>(key)); // TODO: eliminate const_cast
-      if(iter!=this->end()) {
-        // found it!
-        res=make_pair(iter,false);
-      } else {
-        res=this->insert(const_cast<KeyType*>(key)); // TODO: eliminate const_cast
-      }
-      res2=make_pair(res.second,*res.first);
-    }
-    return res2;
+    KeyType* k=const_cast<KeyType*>(key); // TODO: eliminate const_cast
+    return insertOrLookup(k,shardOf(k));
   }
   const KeyType* processNewOrExisting(const KeyType* s) {
     ProcessingResult res=process(s);
@@ -135,42 +134,30 @@ public:
   //! <true,const KeyType> if new element was inserted
   //! <false,const KeyType> if element already existed
   ProcessingResult process(KeyType key) {
-    ProcessingResult res2;
-#pragma omp critical(HASHSET)
-    {
-    std::pair<typename HSetMaintainer::iterator, bool> res;
-    typename HSetMaintainer::iterator iter=this->find(&key);
-    if(iter!=this->end()) {
-      // found it!
-      res=make_pair(iter,false);
-    } else {
-      // converting the stack allocated object to heap allocated
-      // this copies the entire object
-      // TODO: this can be avoided by providing a process function with a pointer arg
-      //       this requires a more detailed result: pointer exists, alternate pointer with equal object exists, does not exist
-      KeyType* keyPtr=new KeyType();
-      *keyPtr=key;
-      res=this->insert(keyPtr);
+    size_t shard=shardOf(&key);
+    // the common case of an existing element needs neither a copy nor a second lock
+    if(const KeyType* existing=lookup(&key,shard))
+      return make_pair(false,existing);
+    // converting the stack allocated object to heap allocated
+    // this copies the entire object, which is done without holding the lock
+    KeyType* keyPtr=new KeyType();
+    *keyPtr=key;
+    ProcessingResult res=insertOrLookup(keyPtr,shard);
+    if(!res.first) {
+      // another thread inserted an equal element meanwhile
+      delete keyPtr;
     }
 #ifdef HSET_MAINTAINER_DEBUG_MODE
-    std::pair<typename HSetMaintainer::iterator, bool> res1;
-    res1=this->insert(key);
-    std::pair<typename HSetMaintainer::iterator, bool> res2;
-    res2=this->insert(key);
-    if(!(res1==res2)) {
+    if(lookup(&key,shard)!=res.second) {
       cerr<< "Error: HsetMaintainer failed:"<<endl;
-      cerr<< "res1:"<<(*res1.first).toString()<<":"<<res1.second<<endl;
-      cerr<< "res2:"<<(*res2.first).toString()<<":"<<res2.second<<endl;
+      cerr<< "res:"<<res.second->toString()<<":"<<res.first<<endl;
       exit(1);
     }
     cerr << "HSET insert OK"<<endl;
 #endif
-    res2=make_pair(res.second,*res.first);
-    }
-    return res2;
+    return res;
   }
   const KeyType* processNew(KeyType& s) {
-    //std::pair<typename HSetMaintainer::iterator, bool> res=process(s);
     ProcessingResult res=process(s);
     if(res.first!=true) {
       cerr<< "Error: HsetMaintainer::processNew failed:"<<endl;
@@ -185,40 +172,123 @@ public:
     ProcessingResult res=process(s);
     return res.second;
   }
-  long numberOf() { return HSetMaintainer<KeyType,HashFun,EqualToPred>::size(); }
+
+  // container interface (not thread safe)
+  const_iterator begin() const { return const_iterator(&_shards,0,_shards[0].begin()); }
+  const_iterator end() const { return const_iterator(&_shards,_shards.size(),typename Shard::const_iterator()); }
+  const_iterator find(KeyType* key) const {
+    size_t shard=shardOf(key);
+    typename Shard::const_iterator i=_shards[shard].find(key);
+    return i==_shards[shard].end() ? end() : const_iterator(&_shards,shard,i);
+  }
+  std::pair<const_iterator,bool> insert(KeyType* key) {
+    size_t shard=shardOf(key);
+    std::pair<typename Shard::const_iterator,bool> res=_shards[shard].insert(key);
+    return make_pair(const_iterator(&_shards,shard,res.first),res.second);
+  }
+  size_t erase(KeyType* key) {
+    return _shards[shardOf(key)].erase(key);
+  }
+  const_iterator erase(const_iterator pos) {
+    size_t shard=pos.shard();
+    typename Shard::const_iterator next=_shards[shard].erase(pos.position());
+    return const_iterator(&_shards,shard,next);
+  }
+  void clear() {
+    for(size_t i=0;i<_shards.size();++i)
+      _shards[i].clear();
+  }
+  size_t size() const {
+    size_t n=0;
+    for(size_t i=0;i<_shards.size();++i)
+      n+=_shards[i].size();
+    return n;
+  }
+  bool empty() const { return size()==0; }
+  void max_load_factor(float f) {
+    for(size_t i=0;i<_shards.size();++i)
+      _shards[i].max_load_factor(f);
+  }
+  size_t bucket_count() const {
+    size_t n=0;
+    for(size_t i=0;i<_shards.size();++i)
+      n+=_shards[i].bucket_count();
+    return n;
+  }
+  float load_factor() const {
+    size_t buckets=bucket_count();
+    return buckets ? (float)size()/buckets : 0.0f;
+  }
+
+  long numberOf() { return size(); }
 
   long maxCollisions() {
-#ifdef USE_CUSTOM_HSET
-    return HSetMaintainer<KeyType,HashFun,EqualToPred>::max_collisions();
-#else
     //MS:2012
     size_t max=0;
-    for(size_t i=0; i<HSetMaintainer<KeyType,HashFun,EqualToPred>::bucket_count();++i) {
-      if(HSetMaintainer<KeyType,HashFun,EqualToPred>::bucket_size(i)>max) {
-        max=HSetMaintainer<KeyType,HashFun,EqualToPred>::bucket_size(i);
+    for(size_t s=0;s<_shards.size();++s) {
+      for(size_t i=0; i<_shards[s].bucket_count();++i) {
+        if(_shards[s].bucket_size(i)>max) {
+          max=_shards[s].bucket_size(i);
+        }
       }
     }
     return max;
-#endif
   }
 
   double loadFactor() {
-    return HSetMaintainer<KeyType,HashFun,EqualToPred>::load_factor();
+    return load_factor();
   }
 
   long memorySize() const {
     long mem=0;
-    for(typename HSetMaintainer<KeyType,HashFun,EqualToPred>::const_iterator i
-          =HSetMaintainer<KeyType,HashFun,EqualToPred>::begin();
-        i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end();
-        ++i) {
+    for(const_iterator i=begin();i!=end();++i) {
       mem+=(*i)->memorySize();
     }
     return mem+sizeof(*this);
   }
 
  private:
-  //const KeyType* ptr(KeyType& s) {}
+  // The shard is chosen by the high bits of the scrambled hash value, which are independent of the low bits the shards use
+  // to choose buckets.
+  size_t shardOf(KeyType* key) const {
+    uint64_t h=(uint64_t)HashFun()(key)*0x9e3779b97f4a7c15ull;
+    return (size_t)(h>>32)&(_shards.size()-1);
+  }
+
+  const KeyType* lookup(KeyType* key, size_t shard) {
+    const KeyType* ret=0;
+    lock(shard);
+    typename Shard::const_iterator i=_shards[shard].find(key);
+    if(i!=_shards[shard].end())
+      ret=*i;
+    unlock(shard);
+    return ret;
+  }
+
+  ProcessingResult insertOrLookup(KeyType* key, size_t shard) {
+    lock(shard);
+    std::pair<typename Shard::const_iterator,bool> res=_shards[shard].insert(key);
+    ProcessingResult ret=make_pair(res.second,*res.first);
+    unlock(shard);
+    return ret;
+  }
+
+#ifdef _OPENMP
+  void initLocks() {
+    _locks.resize(_shards.size());
+    for(size_t i=0;i<_locks.size();++i)
+      omp_init_lock(&_locks[i]);
+  }
+  void lock(size_t shard) { omp_set_lock(&_locks[shard]); }
+  void unlock(size_t shard) { omp_unset_lock(&_locks[shard]); }
+  std::vector<omp_lock_t> _locks;
+#else
+  void initLocks() {}
+  void lock(size_t) {}
+  void unlock(size_t) {}
+#endif
+
+  std::vector<Shard> _shards;
 };
 
 #endif
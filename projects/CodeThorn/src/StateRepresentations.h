@@ -13,6 +13,10 @@
 #include <set>
 #include <map>
 #include <utility>
+#include <vector>
+#include <iterator>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
 #include "Labeler.h"
 #include "CFAnalysis.h"
 #include "AType.h"
@@ -36,16 +40,91 @@ using namespace SPRAY;
 
 namespace CodeThorn {
 
+// number of variables per chunk of a PState (at most 32)
+#ifndef PSTATE_CHUNK_SIZE
+#define PSTATE_CHUNK_SIZE 16
+#endif
+
 /*! 
   * \author Markus Schordan
   * \date 2012.
+
+  A PState maps variables to abstract values. The values are stored in
+  chunks of PSTATE_CHUNK_SIZE consecutive variable ids. Chunks are shared
+  between copies of a PState and are copied only when one of the copies
+  writes to a variable of the chunk (copy on write). Therefore copying a
+  PState copies only the chunk pointers, and a successor state only
+  allocates the chunks of the variables that the transition changes.
+
+  The hash value is the sum of the hash values of the chunks, each of
+  which is cached. Writing to a variable marks its chunk, and hash()
+  recomputes only the marked chunks.
+
+  The interface is the subset of std::map that is used by the analyzer.
+  Iterators visit the variables in the order of their ids and yield
+  (VariableId,CppCapsuleAValue) pairs. The reference returned by
+  operator[] must not be used after the PState is copied.
  */
-class PState : public map<VariableId,CodeThorn::CppCapsuleAValue> {
+class PState {
+ private:
+  struct Chunk {
+    Chunk():present(0) {}
+    unsigned int present; // bit i is set if values[i] belongs to the state
+    CodeThorn::CppCapsuleAValue values[PSTATE_CHUNK_SIZE];
+  };
+  typedef boost::shared_ptr<Chunk> ChunkPtr;
  public:
-    PState() {
+  typedef VariableId key_type;
+  typedef CodeThorn::CppCapsuleAValue mapped_type;
+  typedef pair<VariableId,CodeThorn::CppCapsuleAValue> value_type;
+
+  //! the elements cannot be modified through an iterator, therefore iterator and const_iterator are the same type
+  class const_iterator : public std::iterator<std::forward_iterator_tag, value_type> {
+  public:
+    const_iterator():_pstate(0),_pos(0) {}
+    const_iterator(const PState* pstate, size_t pos):_pstate(pstate),_pos(pos) {
+      skipAbsent();
     }
+    const value_type& operator*() const { return _value; }
+    const value_type* operator->() const { return &_value; }
+    const_iterator& operator++() {
+      ++_pos;
+      skipAbsent();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator old=*this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const const_iterator& other) const { return _pos==other._pos; }
+    bool operator!=(const const_iterator& other) const { return _pos!=other._pos; }
+  private:
+    // moves to the next variable of the state and caches its (id,value) pair
+    void skipAbsent();
+    const PState* _pstate;
+    size_t _pos;
+    value_type _value;
+  };
+  typedef const_iterator iterator;
+
+  PState():_size(0),_hash(0) {}
   friend ostream& operator<<(ostream& os, const PState& value);
   friend istream& operator>>(istream& os, PState& value);
+  friend bool operator==(const PState& c1, const PState& c2);
+
+  // map interface
+  CodeThorn::CppCapsuleAValue& operator[](VariableId varId);
+  const_iterator begin() const { return const_iterator(this,0); }
+  const_iterator end() const { return const_iterator(this,endPos()); }
+  const_iterator find(VariableId varId) const;
+  size_t erase(VariableId varId);
+  void clear();
+  size_t size() const { return _size; }
+  bool empty() const { return _size==0; }
+  //! hash value of the state; only the chunks written since the last call are rehashed
+  long hash() const;
+
   bool varExists(VariableId varId) const;
   bool varIsConst(VariableId varId) const;
   bool varIsTop(VariableId varId) const;
@@ -62,6 +141,22 @@ class PState : public map<VariableId,CodeThorn::CppCapsuleAValue> {
   void setVariableToTop(VariableId varId);
   void setVariableToValue(VariableId varId, CodeThorn::CppCapsuleAValue val);
   VariableIdSet getVariableIds() const;
+ private:
+  size_t endPos() const { return _chunks.size()*PSTATE_CHUNK_SIZE; }
+  // returns the chunk that holds position pos (chunk and slot of a variable id), or 0
+  const Chunk* chunkOf(size_t pos) const {
+    size_t c=pos/PSTATE_CHUNK_SIZE;
+    return c<_chunks.size() ? _chunks[c].get() : 0;
+  }
+  // returns chunk c for writing: allocates it if necessary, unshares it, and marks its hash as outdated
+  Chunk& writableChunk(size_t c);
+  uint64_t chunkHash(size_t c) const;
+  std::vector<ChunkPtr> _chunks; // null for chunks without variables
+  size_t _size;
+  // hash of the state without the chunks in _dirtyChunks
+  mutable uint64_t _hash;
+  mutable std::vector<uint64_t> _chunkHashes;
+  mutable std::vector<size_t> _dirtyChunks;
 };
 
   ostream& operator<<(ostream& os, const PState& value);
@@ -69,48 +164,19 @@ class PState : public map<VariableId,CodeThorn::CppCapsuleAValue> {
 
   typedef set<const PState*> PStatePtrSet;
 
-#ifdef USE_CUSTOM_HSET
-class PStateHashFun {
-   public:
-    PStateHashFun(long prime=9999991) : tabSize(prime) {}
-    long operator()(PState s) const {
-      unsigned int hash=1;
-      for(PState::iterator i=s.begin();i!=s.end();++i) {
-        hash=((hash<<8)+((long)(*i).second.getValue().hash()))^hash;
-      }
-      return long(hash) % tabSize;
-    }
-      long tableSize() const { return tabSize;}
-   private:
-    long tabSize;
-};
-#else
 class PStateHashFun {
    public:
     PStateHashFun() {}
     long operator()(PState* s) const {
-      unsigned int hash=1;
-      for(PState::iterator i=s->begin();i!=s->end();++i) {
-        hash=((hash<<8)+((long)(*i).second.getValue().hash()))^hash;
-      }
-      return long(hash);
+      return s->hash();
     }
    private:
 };
-#endif
 class PStateEqualToPred {
    public:
     PStateEqualToPred() {}
     bool operator()(PState* s1, PState* s2) const {
-      if(s1->size()!=s2->size()) {
-        return false;
-      } else {
-        for(PState::iterator i1=s1->begin(), i2=s2->begin();i1!=s1->end();(++i1,++i2)) {
-          if(*i1!=*i2)
-            return false;
-        }
-      }
-      return true;
+      return s1->hash()==s2->hash() && *s1==*s2;
     }
    private:
 };
@@ -203,11 +269,9 @@ class EState {
 // define order for PState elements (necessary for PStateSet)
 #ifdef  USER_DEFINED_PSTATE_COMP
 bool operator<(const PState& c1, const PState& c2);
-#if 0
+#endif
 bool operator==(const PState& c1, const PState& c2);
 bool operator!=(const PState& c1, const PState& c2);
-#endif
-#endif
 
 // define order for EState elements (necessary for EStateSet)
 bool operator<(const EState& c1, const EState& c2);
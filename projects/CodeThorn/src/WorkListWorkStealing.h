@@ -0,0 +1,73 @@
+#ifndef WORKLIST_WORK_STEALING_H
+#define WORKLIST_WORK_STEALING_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <omp.h>
+
+namespace CodeThorn {
+
+/*!
+  A work list for parallel state space exploration. Each thread owns a
+  deque of elements. A thread adds new elements to its own deque and
+  takes elements from its own deque; only if its deque is empty it
+  steals half of the elements of another thread's deque (from the end
+  the owner does not take from). Each deque has its own lock, therefore
+  threads only contend when they steal.
+
+  Termination: every element that is added is pending until the thread
+  that took it calls finished(), which must happen after all successors
+  of the element have been added. The exploration is complete when no
+  element is pending (isTerminated()).
+
+  Elements are taken in LIFO order (depth-first) or FIFO order
+  (breadth-first) per thread. There is no global order between threads.
+ */
+template <typename Element>
+class WorkListWorkStealing {
+ public:
+  WorkListWorkStealing(int numberOfThreads, bool lifo);
+  ~WorkListWorkStealing();
+  //! adds an element to the deque of thread threadNum
+  void add(int threadNum, Element elem);
+  //! takes an element from the deque of thread threadNum, or steals one. Returns false if no element was found.
+  bool take(int threadNum, Element& elem);
+  //! must be called by a thread when it has processed an element obtained with take
+  void finished(int threadNum);
+  //! true if all elements that were added have been processed
+  bool isTerminated();
+  //! number of elements in all deques (not including elements that are being processed)
+  size_t size();
+  //! removes all elements from all deques (not thread safe)
+  std::deque<Element> removeAll();
+  //! per thread statistics: processed elements, steals, idle time, and throughput
+  std::string statisticsToString();
+ private:
+  struct ThreadData {
+    ThreadData():numProcessed(0),numAdded(0),numStolen(0),numSteals(0),numFailedSteals(0),idleTime(0.0),idleSince(-1.0) {}
+    omp_lock_t lock;
+    std::deque<Element> deque;
+    long numProcessed;
+    long numAdded;
+    long numStolen;       // number of elements stolen from other threads
+    long numSteals;       // number of successful steal operations
+    long numFailedSteals;
+    double idleTime;      // time spent without an element
+    double idleSince;     // start of the current idle period, or negative
+    char padding[64];     // avoids false sharing with the data of the next thread
+  };
+  // steals elements from another thread into the deque of thread threadNum. Returns false if all other deques are empty.
+  bool steal(int threadNum);
+  std::vector<ThreadData*> _threads;
+  bool _lifo;
+  long _numPending; // number of elements added but not finished
+  double _startTime;
+};
+
+} // end of namespace CodeThorn
+
+// template implementation code
+#include "WorkListWorkStealing.C"
+
+#endif
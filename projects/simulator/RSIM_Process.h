@@ -14,7 +14,8 @@ public:
     /** Creates an empty process containing no threads. */
     explicit RSIM_Process(RSIM_Simulator *simulator)
         : simulator(simulator), tracing_file(NULL), tracing_flags(0),
-          brk_va(0), mmap_start(0x40000000ul), mmap_recycle(false), disassembler(NULL), futexes(NULL),
+          brk_va(0), mmap_start(0x40000000ul), mmap_recycle(false), disassembler(NULL),
+          tcache_enabled(false), futexes(NULL),
           interpretation(NULL), ep_orig_va(0), ep_start_va(0),
           terminated(false), termination_status(0), project(NULL), core_flags(0), btrace_file(NULL),
           vdso_mapped_va(0), vdso_entry_va(0),
@@ -433,11 +434,100 @@ public:
         return disassembler;
     }
 
-    /** Returns the total number of instructions processed across all threads.
+    /** Returns the total number of instructions processed across all threads, including threads that have exited.
      *
      *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
     size_t get_ninsns() const;
 
+    /** Reports the total number of instructions processed, the average instruction rate since the process was created, and
+     *  translation cache statistics if the cache is enabled.  Nothing is reported if @p mesg is null or disabled.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    void report_progress(RTS_Message *mesg) const;
+
+
+
+    /**************************************************************************************************************************
+     *                                  Translation cache
+     **************************************************************************************************************************/
+public:
+    /** A basic block in the translation cache.  The instructions are those returned by get_instruction() for consecutive
+     *  addresses, starting at the block's address and ending with the first instruction that terminates a basic block.  When
+     *  memory from which a block was decoded changes, the block is removed from the cache and marked as invalid, but it is not
+     *  deleted since a thread might still be executing it.  Threads must check the @p valid flag before using each
+     *  instruction. */
+    struct TranslatedBlock {
+        static const size_t max_insns = 64;             /**< Maximum number of instructions per block. */
+        TranslatedBlock(): valid(true) {}
+        std::vector<SgAsmX86Instruction*> insns;        /**< Non-empty list of instructions in execution order. */
+        volatile bool valid;                            /**< Cleared when the underlying memory changes. */
+    };
+    typedef boost::shared_ptr<TranslatedBlock> TranslatedBlockPtr;
+
+    /** Translation cache statistics. */
+    struct TranslationCacheStats {
+        TranslationCacheStats(): nblocks(0), ninsns(0), ninvalidated(0), nflushes(0) {}
+        size_t nblocks;                                 /**< Number of blocks translated. */
+        size_t ninsns;                                  /**< Number of instructions in all translated blocks. */
+        size_t ninvalidated;                            /**< Number of blocks invalidated by writes to their memory. */
+        size_t nflushes;                                /**< Number of times the whole cache was discarded. */
+    };
+
+private:
+    typedef std::map<rose_addr_t, TranslatedBlockPtr> TranslationCache;
+    typedef std::map<rose_addr_t/*page number*/, std::set<rose_addr_t>/*block addresses*/> TranslationCachePages;
+    bool tcache_enabled;                                /**< Whether threads fetch instructions from the translation cache. */
+    TranslationCache tcache;                            /**< Translated blocks indexed by starting address. */
+    TranslationCachePages tcache_pages;                 /**< Blocks that were decoded from each page of memory. */
+    TranslationCacheStats tcache_stats;
+
+public:
+    /** Property: whether the translation cache is enabled.  When enabled, threads fetch instructions from basic blocks that
+     *  were decoded once (see get_translated_block()) instead of calling get_instruction() for every instruction they execute.
+     *  Fetching from the cache avoids the process lock and the comparison of the cached instruction with the current memory
+     *  contents, but it also means that memory callbacks do not see instruction fetches from cached blocks.  The cache is
+     *  disabled by default.
+     *
+     *  Thread safety:  These methods are thread safe, but the property should be set before the specimen starts executing.
+     *  @{ */
+    bool get_tcache() const {
+        return tcache_enabled;
+    }
+    void set_tcache(bool b) {
+        tcache_enabled = b;
+    }
+    /** @} */
+
+    /** Returns the translated basic block starting at the specified address, decoding it with get_instruction() if it's not
+     *  cached yet.  The first instruction must decode (otherwise Disassembler::Exception is thrown), but the block ends early
+     *  at any following instruction that cannot be decoded.  The returned block is invalid (and not cached) if memory changed
+     *  while it was being decoded.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    TranslatedBlockPtr get_translated_block(rose_addr_t va);
+
+    /** Invalidates translated blocks that were decoded from the specified memory.  This is called automatically when specimen
+     *  memory is written with mem_write() or when the mapping of the memory changes.  Invalidation is page granular.  Memory
+     *  that is modified through a pointer returned by my_addr() must be invalidated explicitly.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    void tcache_invalidate(rose_addr_t va, size_t size);
+
+    /** Discards all translated blocks.  This is called automatically when a memory transaction is rolled back.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    void tcache_flush();
+
+    /** Returns translation cache statistics.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    TranslationCacheStats get_tcache_stats() const;
+
+private:
+    /* Same as tcache_invalidate() and tcache_flush() but the caller must hold the process write lock. */
+    void tcache_invalidate_nolock(rose_addr_t va, size_t size);
+    void tcache_flush_nolock();
+
 
 
     /**************************************************************************************************************************
@@ -743,6 +833,7 @@ public:
 
 private:
     std::map<pid_t, RSIM_Thread*> threads;      /**< All threads associated with this process. */
+    size_t ninsns_exited;                       /**< Instructions processed by threads that have been removed. */
 
 private:
     unsigned core_flags;                        /**< Bit vector describing how to produce core dumps. */
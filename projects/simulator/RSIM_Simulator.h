@@ -185,7 +185,7 @@ public:
      *  initial process. */
     RSIM_Simulator()
         : global_semaphore(NULL),
-          tracing_flags(0), core_flags(CORE_ELF), btrace_file(NULL), active(0), process(NULL), entry_va(0) {
+          tracing_flags(0), core_flags(CORE_ELF), btrace_file(NULL), tcache(false), active(0), process(NULL), entry_va(0) {
         ctor();
     }
 
@@ -688,6 +688,7 @@ private:
     std::string interp_name;            /**< Name of command-line specified interpreter for dynamic linking. */
     std::vector<std::string> vdso_paths;/**< Files and/or directories to search for a virtual dynamic shared library. */
     FILE *btrace_file;                  /**< Name for binary trace file, which will log info about process execution. */
+    bool tcache;                        /**< Whether the process fetches instructions from its translation cache. */
 
     /* Simulator activation/deactivation */
     unsigned active;                    /**< Levels of activation. See activate(). */
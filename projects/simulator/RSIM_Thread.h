@@ -18,7 +18,7 @@ public:
     RSIM_Thread(RSIM_Process *process)
         : process(process), my_tid(-1),
           mesg_prefix(this), report_interval(10.0), do_coredump(true), show_exceptions(true),
-          policy(this), semantics(policy),
+          tblock_idx(0), policy(this), semantics(policy),
           robust_list_head_va(0), clear_child_tid(0) {
         real_thread = pthread_self();
         memset(trace_mesg, 0, sizeof trace_mesg);
@@ -581,9 +581,15 @@ public:
 
     /** Returns instruction at current IP, disassembling it if necessary, and caching it.  Since the simulated memory belongs
      *  to the entire RSIM_Process, all this method does is obtain the thread's current instruction address and then has the
-     *  RSIM_Process disassemble the instruction. */
+     *  RSIM_Process disassemble the instruction.  If the process' translation cache is enabled then the instruction comes
+     *  from the thread's current translated block when execution continues sequentially in that block, and otherwise from the
+     *  block that starts at the current IP. */
     SgAsmX86Instruction *current_insn();
 
+private:
+    RSIM_Process::TranslatedBlockPtr tblock;    /**< Translated block being executed, if any. See current_insn(). */
+    size_t tblock_idx;                          /**< Index of the last instruction returned from tblock. */
+
 
     /**************************************************************************************************************************
      *                                  Dynamic Linking
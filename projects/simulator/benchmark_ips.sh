@@ -0,0 +1,51 @@
+#!/bin/bash
+# Measures simulation speed in instructions per second, with and without the translation cache (the x86sim "--tcache" switch),
+# for each specimen named on the command line.  The specimens are run the same way as the syscall and pthread tests (see
+# syscall_tests.conf) except their output is discarded.  Specimens that do not finish within the time limit are reported but
+# not counted in the totals.
+#
+# Usage: benchmark_ips.sh X86SIM SPECIMENS...
+#        The "benchmark-ips" makefile target runs this script for all syscall and pthread test specimens.
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 X86SIM SPECIMENS..." >&2
+    exit 1
+fi
+x86sim="$1"; shift
+: ${TIME_LIMIT:=2m}
+
+tmpdir=`pwd`/tmp-sim
+mkdir -p "$tmpdir"
+log="$tmpdir/benchmark_ips.$$"
+trap "rm -f $log" EXIT
+
+# Runs one specimen and prints "INSNS SECONDS", or nothing if the simulator did not report its final instruction count.
+run_one () {
+    local mode="$1" specimen="$2"
+    setarch i386 -LRB3 env X86SIM_LD_PRELOAD= TMPDIR="$tmpdir" \
+        timeout $TIME_LIMIT "$x86sim" --debug=progress --vdso=/dev/null $mode "$specimen" </dev/null >/dev/null 2>"$log"
+    sed -n 's/.*processed \([0-9]*\) insns in \([0-9.]*\) sec .* total$/\1 \2/p' "$log" |tail -n1
+}
+
+printf "%-40s %12s %12s %12s %8s\n" specimen insns "ips" "ips(tcache)" speedup
+total_insns=0; total_secs=0; total_secs_tc=0
+for specimen in "$@"; do
+    name=`basename "$specimen"`
+    plain=`run_one "" "$specimen"`
+    cached=`run_one --tcache "$specimen"`
+    if [ -z "$plain" -o -z "$cached" ]; then
+        printf "%-40s %12s\n" "$name" "(no result)"
+        continue
+    fi
+    set -- $plain $cached
+    rates=`echo $plain $cached |awk '{s=($2>0.001?$2:0.001); t=($4>0.001?$4:0.001); printf "%f %f %f", $1/s, $3/t, s/t}'`
+    printf "%-40s %12d %12.0f %12.0f %7.2fx\n" "$name" $1 $rates
+    total_insns=$((total_insns + $1))
+    total_secs=`echo $total_secs $2 |awk '{print $1+$2}'`
+    total_secs_tc=`echo $total_secs_tc $4 |awk '{print $1+$2}'`
+done
+
+if [ $total_insns -gt 0 ]; then
+    printf "%-40s %12d %12.0f %12.0f %7.2fx\n" total $total_insns \
+        `echo $total_insns $total_secs $total_secs_tc |awk '{printf "%f %f %f", $1/$2, $1/$3, $2/$3}'`
+fi
@@ -21,6 +21,8 @@
 //    7) What about base class qualification? I might have forgotten this one! No this is handled using standard rules (above).
 
 
+#include <boost/unordered_map.hpp>
+
 // API function for new hidden list support.
 void generateNameQualificationSupport( SgNode* node, std::set<SgNode*> & referencedNameSet );
 
@@ -100,6 +102,17 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
        // specified. I think this only happens for the index in the SgArrayType.
           SgScopeStatement* explictlySpecifiedCurrentScope;
 
+       // Memoized results of nameQualificationDepth() for declarations, keyed by (declaration, current scope, position 
+       // statement).  The counter records evaluations that set name qualification as a side effect (template arguments 
+       // and nested traversals); results computed while it changes are not memoized.
+          typedef std::pair<SgDeclarationStatement*,std::pair<SgScopeStatement*,SgStatement*> > QualificationDepthKey;
+          typedef boost::unordered_map<QualificationDepthKey,int> QualificationDepthCache;
+          QualificationDepthCache qualificationDepthCache;
+          size_t numberOfNameQualificationSideEffects;
+
+       // Uncached implementation of nameQualificationDepth() for declarations.
+          int evaluateNameQualificationDepth ( SgDeclarationStatement* declaration, SgScopeStatement* currentScope, SgStatement* positionStatement, bool forceMoreNameQualification );
+
      public:
        // DQ (4/3/2014): This map of sets is build once and then used to resolve when declarations have been
        // placed into scopes where they would permit name qualification (see test2014_32.C).
@@ -110,12 +110,20 @@ public:
     }
 
     /** Returns the mask for the specified word. The mask determines which bits the pattern cares about. */
-    T mask(size_t wordnum) {
+    T mask(size_t wordnum) const {
         if (wordnum >= mask_.size())
             return 0;
         return mask_[wordnum];
     }
 
+    /** Returns the value of one word of one alternative.  Only the bits that are set in the word's mask are significant. */
+    T pattern(size_t altnum, size_t wordnum) const {
+        assert(altnum < patterns_.size());
+        if (wordnum >= mask_.size())
+            return 0;
+        return patterns_[altnum][wordnum] & mask_[wordnum];
+    }
+
     /** Returns invariant bits.  Given a set of of bits and a word number, this method returns values for bits that must be set
      *  or cleared and a mask indicating which bits are invariant.  For instance, if a pattern's alternatives all require that
      *  bits at positions 24 (inclusive) to 32 (exclusive) have the value 0xbe, don't care about bits at positions 8 to 24, and
@@ -390,10 +398,13 @@ public:
 
     /** Returns true if this pattern matches the specified values.
      * @{ */
-    bool matches(const std::vector<T> value_words) const {
+    bool matches(const std::vector<T> &value_words) const {
+        return matches(value_words.empty() ? NULL : &value_words[0], value_words.size());
+    }
+    bool matches(const T *value_words, size_t sz) const {
         if (0==nalternatives())
             return true;
-        if (value_words.size() < nwords())
+        if (sz < nwords())
             return false;
         for (size_t altnum=0; altnum<nalternatives(); ++altnum) {
             bool eq = true;
@@ -404,12 +415,6 @@ public:
         }
         return false;
     }
-    bool matches(const T *value_words, size_t sz) const {
-        std::vector<T> vv;
-        for (size_t i=0; i<sz; ++i)
-            vv.push_back(value_words[i]);
-        return matches(vv);
-    }
     /** @} */
 
     /** Returns true if one word of this pattern matches the specified value. */
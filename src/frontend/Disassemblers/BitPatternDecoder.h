@@ -0,0 +1,220 @@
+#ifndef ROSE_BitPatternDecoder_H
+#define ROSE_BitPatternDecoder_H
+
+#include "BitPattern.h"
+
+#include <sawyer/Optional.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+/** Decision tree that maps instruction words to the first of an ordered list of bit patterns that matches.
+ *
+ *  Pattern-driven disassemblers describe each instruction by a BitPattern and look up an instruction word by trying the
+ *  patterns one at a time.  A BitPatternDecoder holds the same ordered list of (pattern, value) pairs, but once @ref build
+ *  has been called it compiles them into a binary decision tree whose interior nodes each test one bit of the first word.
+ *  A lookup walks at most one node per bit of @p T and then checks only the few candidates left at the leaf. The result is
+ *  always the same as a linear scan of the list: the value of the first pattern, in insertion order, that matches the words.
+ *
+ *  The candidates are the individual alternatives of the patterns rather than whole patterns, so a pattern with many
+ *  alternatives (such as one that accepts a set of effective address modes) costs one masked comparison at a leaf rather
+ *  than one per alternative.  Alternatives that don't care about a tested bit appear on both sides of it, so branches often
+ *  end up with the same candidates; such subtrees are built once and shared.  Bits of words after the first are checked
+ *  only at the leaves.
+ *
+ * @code
+ *  BitPatternDecoder<uint16_t, Decoder*> decoder;
+ *  decoder.insert(decoderA->pattern, decoderA);
+ *  decoder.insert(decoderB->pattern, decoderB);
+ *  decoder.build();
+ *  if (Decoder *d = decoder.find(words, nwords).orElse(NULL))
+ *      ...
+ * @endcode */
+template<typename T, class Value>
+class BitPatternDecoder {
+public:
+    typedef BitPattern<T> Pattern;
+
+private:
+    // One alternative of one pattern. Its masks are words_[offset] through words_[offset+nwords-1], and the values that the
+    // masked bits must have follow immediately after.  A pattern without alternatives matches everything and is represented
+    // by a single alternative with no words.
+    struct Alternative {
+        size_t valueIdx;                                // index into values_; also the priority of the pattern
+        size_t offset;
+        size_t nwords;
+        Alternative(size_t valueIdx, size_t offset, size_t nwords): valueIdx(valueIdx), offset(offset), nwords(nwords) {}
+    };
+
+    // An interior node tests bit "bit" of the first word and continues at child[0] or child[1]; a leaf has bit==0 and its
+    // candidate alternatives, in priority order, are leafAlternatives_[begin] through leafAlternatives_[end-1].
+    struct Node {
+        T bit;
+        size_t child[2];
+        size_t begin, end;
+        Node(): bit(0), begin(0), end(0) { child[0] = child[1] = 0; }
+    };
+
+    // Root node of the subtree already built for each list of candidates.
+    typedef std::map<std::vector<size_t>, size_t> Subtrees;
+
+    std::vector<Value> values_;                         // one per pattern, in priority order
+    std::vector<Alternative> alternatives_;             // all alternatives of all patterns, in priority order
+    std::vector<T> words_;                              // masks and values for alternatives_
+    std::vector<Node> nodes_;                           // the decision tree; nodes_[0] is the root; empty if not built
+    std::vector<size_t> leafAlternatives_;              // candidate lists for the leaves
+    size_t maxLeafSize_;                                // stop splitting when this few candidates remain
+
+public:
+    /** Creates an empty decoder. */
+    BitPatternDecoder(): maxLeafSize_(8) {}
+
+    /** Removes all patterns and the decision tree. */
+    void clear() {
+        values_.clear();
+        alternatives_.clear();
+        words_.clear();
+        nodes_.clear();
+        leafAlternatives_.clear();
+    }
+
+    /** Number of patterns. */
+    size_t size() const {
+        return values_.size();
+    }
+
+    /** Number of nodes in the decision tree. Returns zero if the tree has not been built. */
+    size_t nNodes() const {
+        return nodes_.size();
+    }
+
+    /** Appends a pattern.  The new pattern has lower priority than all patterns already present.  Any existing decision tree
+     *  is discarded; lookups are linear until @ref build is called again. */
+    void insert(const Pattern &pattern, const Value &value) {
+        size_t valueIdx = values_.size();
+        values_.push_back(value);
+        if (0==pattern.nalternatives()) {
+            alternatives_.push_back(Alternative(valueIdx, words_.size(), 0));
+        } else {
+            for (size_t altnum=0; altnum<pattern.nalternatives(); ++altnum) {
+                alternatives_.push_back(Alternative(valueIdx, words_.size(), pattern.nwords()));
+                for (size_t wordnum=0; wordnum<pattern.nwords(); ++wordnum)
+                    words_.push_back(pattern.mask(wordnum));
+                for (size_t wordnum=0; wordnum<pattern.nwords(); ++wordnum)
+                    words_.push_back(pattern.pattern(altnum, wordnum));
+            }
+        }
+        nodes_.clear();
+        leafAlternatives_.clear();
+    }
+
+    /** Compiles the patterns into a decision tree.  This should be called once after all patterns are inserted. */
+    void build() {
+        nodes_.clear();
+        leafAlternatives_.clear();
+        std::vector<size_t> candidates;
+        candidates.reserve(alternatives_.size());
+        for (size_t i=0; i<alternatives_.size(); ++i)
+            candidates.push_back(i);
+        Subtrees subtrees;
+        buildNode(candidates, 0, subtrees);
+    }
+
+    /** Returns the value of the first pattern that matches the words.  Returns nothing if no pattern matches. */
+    Sawyer::Optional<Value> find(const T *words, size_t nwords) const {
+        if (nodes_.empty() || 0==nwords) {
+            for (size_t i=0; i<alternatives_.size(); ++i) {
+                if (matches(alternatives_[i], words, nwords))
+                    return values_[alternatives_[i].valueIdx];
+            }
+            return Sawyer::Nothing();
+        }
+
+        const Node *node = &nodes_[0];
+        while (node->bit != 0)
+            node = &nodes_[node->child[(words[0] & node->bit) ? 1 : 0]];
+        for (size_t i=node->begin; i<node->end; ++i) {
+            const Alternative &alt = alternatives_[leafAlternatives_[i]];
+            if (matches(alt, words, nwords))
+                return values_[alt.valueIdx];
+        }
+        return Sawyer::Nothing();
+    }
+
+private:
+    bool matches(const Alternative &alt, const T *words, size_t nwords) const {
+        if (0==alt.nwords)
+            return true;
+        if (alt.nwords > nwords)
+            return false;
+        const T *masks = &words_[0] + alt.offset, *bits = masks + alt.nwords;
+        for (size_t wordnum=0; wordnum<alt.nwords; ++wordnum) {
+            if ((words[wordnum] & masks[wordnum]) != bits[wordnum])
+                return false;
+        }
+        return true;
+    }
+
+    // True if the alternative allows the first word's bit to have the specified value.
+    bool allowsBit(const Alternative &alt, T bit, bool isSet) const {
+        if (0==alt.nwords || 0==(words_[alt.offset] & bit))
+            return true;
+        return (0 != (words_[alt.offset + alt.nwords] & bit)) == isSet;
+    }
+
+    // Builds the subtree for the given candidates (in priority order), none of which are ruled out by the bits already tested
+    // on the path from the root. Returns the index of the subtree's root node.  Any subtree built for the same candidates
+    // is reused since the bits it tests only narrow down the candidates, and the leaves check the alternatives in full.
+    size_t buildNode(const std::vector<size_t> &candidates, T testedBits, Subtrees &subtrees) {
+        typename Subtrees::iterator found = subtrees.find(candidates);
+        if (found != subtrees.end())
+            return found->second;
+        size_t nodeIdx = nodes_.size();
+        nodes_.push_back(Node());
+        subtrees.insert(std::make_pair(candidates, nodeIdx));
+
+        // Choose the untested bit that best divides the candidates, i.e., minimizes the larger side.
+        T bestBit = 0;
+        size_t bestLarger = candidates.size(), bestTotal = 0;
+        if (candidates.size() > maxLeafSize_) {
+            for (size_t bitnum=0; bitnum<8*sizeof(T); ++bitnum) {
+                T bit = (T)1 << bitnum;
+                if (testedBits & bit)
+                    continue;
+                size_t n[2] = {0, 0};
+                for (size_t i=0; i<candidates.size(); ++i) {
+                    const Alternative &alt = alternatives_[candidates[i]];
+                    n[0] += allowsBit(alt, bit, false) ? 1 : 0;
+                    n[1] += allowsBit(alt, bit, true) ? 1 : 0;
+                }
+                size_t larger = std::max(n[0], n[1]);
+                if (larger < bestLarger || (larger==bestLarger && bestBit!=0 && n[0]+n[1] < bestTotal)) {
+                    bestBit = bit;
+                    bestLarger = larger;
+                    bestTotal = n[0] + n[1];
+                }
+            }
+        }
+
+        if (0==bestBit) {
+            // Leaf: no bit narrows down the candidates any further
+            nodes_[nodeIdx].begin = leafAlternatives_.size();
+            leafAlternatives_.insert(leafAlternatives_.end(), candidates.begin(), candidates.end());
+            nodes_[nodeIdx].end = leafAlternatives_.size();
+        } else {
+            for (size_t side=0; side<2; ++side) {
+                std::vector<size_t> sub;
+                for (size_t i=0; i<candidates.size(); ++i) {
+                    if (allowsBit(alternatives_[candidates[i]], bestBit, side!=0))
+                        sub.push_back(candidates[i]);
+                }
+                size_t child = buildNode(sub, testedBits | bestBit, subtrees);
+                nodes_[nodeIdx].child[side] = child;    // nodes_ may have been reallocated
+            }
+            nodes_[nodeIdx].bit = bestBit;
+        }
+        return nodeIdx;
+    }
+};
+
+#endif
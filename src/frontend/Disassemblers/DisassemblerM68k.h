@@ -5,6 +5,7 @@
 #include "Disassembler.h"
 #include "InstructionEnumsM68k.h"
 #include "BitPattern.h"
+#include "BitPatternDecoder.h"
 
 namespace rose {
 namespace BinaryAnalysis {
@@ -60,6 +61,10 @@ public:
      *  @p match values. The pointers are managed by the caller and must not be deleted while they are in the table. */
     void insert_idis(M68k*);
 
+    /** Rebuild the decision tree used by find_idis() from the instruction disassembly table. This is called by init() after
+     *  all instruction-specific disassemblers are inserted, and by insert_idis() for insertions made after that. */
+    void build_idis_decoder();
+
     /** Called by disassembleOne() to initialize the disassembler state for the next instruction. */
     void start_instruction(const MemoryMap *map, rose_addr_t start_va) {
         this->map = map;
@@ -190,6 +195,11 @@ private:
     typedef std::list<M68k*> IdisList;
     typedef std::vector<IdisList> IdisTable;
     IdisTable idis_table;
+
+    // The same instruction disassemblers compiled into a decision tree on the bits of the first 16-bit word so that find_idis()
+    // doesn't need to try each pattern of a bucket in turn. Priority order is bucket 0 through 15 followed by the catch-all
+    // bucket 16, each in list order, which yields the same answer as scanning the operator nybble's bucket and then bucket 16.
+    BitPatternDecoder<uint16_t, M68k*> idis_decoder;
 };
 
 } // namespace
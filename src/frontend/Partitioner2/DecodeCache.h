@@ -0,0 +1,134 @@
+#ifndef ROSE_BinaryAnalysis_Partitioner2_DecodeCache_H
+#define ROSE_BinaryAnalysis_Partitioner2_DecodeCache_H
+
+#include "Disassembler.h"
+
+#include <sawyer/Map.h>
+#include <sawyer/SharedPointer.h>
+#include <sawyer/Synchronization.h>
+
+namespace rose {
+namespace BinaryAnalysis {
+
+/** Persistent cache of decoded instructions.
+ *
+ *  A decode cache remembers instructions in a compact serialized form so that an @ref InstructionProvider can rebuild them
+ *  instead of calling the disassembler.  Each entry is keyed by the instruction set architecture, the starting address, and
+ *  the instruction's raw bytes: an entry is used only when the bytes currently mapped at its address are the same bytes that
+ *  were decoded, so one cache can be shared by many related specimens, such as successive versions of a library or
+ *  firmware image.  The address is part of the key because decoded operands may depend on it (e.g., branch targets).
+ *
+ *  A cache may be saved to a file and loaded again by a later run.  The file records the ROSE version that wrote it, and a
+ *  file written by a different version is ignored since its instructions might have been decoded differently.
+ *
+ *  Only instructions whose every node has a serialized form are cached; currently these are the x86 instructions.  Other
+ *  instructions, and addresses that cannot be decoded, are always handed to the disassembler.
+ *
+ *  All methods are thread safe. */
+class DecodeCache: public Sawyer::SharedObject {
+public:
+    typedef Sawyer::SharedPointer<DecodeCache> Ptr;
+
+private:
+    typedef std::pair<std::string, rose_addr_t> Key;    // instruction set architecture and starting address
+    typedef Sawyer::Container::Map<Key, std::vector<std::string> > Entries; // serialized instructions for each key
+
+    Entries entries_;
+    size_t nEntries_;                                   // total number of serialized instructions in entries_
+    std::string fileName_;                              // file to save when destroyed, or empty
+    bool isDirty_;                                      // entries_ changed since it was loaded or saved
+    mutable size_t nHits_, nMisses_;                    // statistics for lookup
+    mutable SAWYER_THREAD_TRAITS::Mutex mutex_;         // protects all data members
+
+protected:
+    DecodeCache(): nEntries_(0), isDirty_(false), nHits_(0), nMisses_(0) {}
+
+    explicit DecodeCache(const std::string &fileName)
+        : nEntries_(0), fileName_(fileName), isDirty_(false), nHits_(0), nMisses_(0) {
+        load(fileName);
+        isDirty_ = false;
+    }
+
+public:
+    /** Destructor saves the cache if it has a file name and has changed. */
+    ~DecodeCache();
+
+    /** Allocating constructor for an in-memory cache. */
+    static Ptr instance() {
+        return Ptr(new DecodeCache);
+    }
+
+    /** Allocating constructor for a cache associated with a file.
+     *
+     *  The file is loaded if it exists, and the cache is saved back to it when the cache is destroyed. */
+    static Ptr instance(const std::string &fileName) {
+        return Ptr(new DecodeCache(fileName));
+    }
+
+    /** Name of the instruction set architecture decoded by a disassembler.
+     *
+     *  The name consists of the register dictionary name, the word size, and the byte order, which together distinguish the
+     *  decoding modes of all disassemblers. */
+    static std::string isaName(const Disassembler*);
+
+    /** Rebuild a cached instruction.
+     *
+     *  Returns a new instruction decoded earlier from the bytes that are currently mapped with execute permission at the
+     *  specified address, or null if there is no such instruction.  The returned instruction is owned by the caller. */
+    SgAsmInstruction* lookup(const std::string &isa, const MemoryMap&, rose_addr_t va) const;
+
+    /** Add an instruction to the cache.
+     *
+     *  The instruction is serialized and stored under its address and raw bytes.  Returns false, without changing the cache,
+     *  if the instruction cannot be serialized. The instruction is not modified and remains owned by the caller. */
+    bool insert(const std::string &isa, SgAsmInstruction*);
+
+    /** Load a cache file.
+     *
+     *  The instructions in the file are added to this cache.  Returns false if the file cannot be read, is malformed, or was
+     *  written by another version of ROSE. */
+    bool load(const std::string &fileName);
+
+    /** Save the cache.
+     *
+     *  Saves the cache to the specified file, or the file associated with the cache, replacing the file atomically.  Returns
+     *  false if the file cannot be written.
+     *
+     * @{ */
+    bool save(const std::string &fileName) const;
+    bool save();
+    /** @} */
+
+    /** Name of the associated file, or empty. */
+    const std::string& fileName() const { return fileName_; }
+
+    /** Number of instructions in the cache. */
+    size_t size() const;
+
+    /** Remove all instructions from the cache. */
+    void clear();
+
+    /** Number of lookups that returned an instruction. */
+    size_t nHits() const;
+
+    /** Number of lookups that returned null. */
+    size_t nMisses() const;
+
+    /** Serialized form of an instruction.
+     *
+     *  Returns false if some node of the instruction has no serialized form. */
+    static bool serialize(SgAsmInstruction*, std::string &out /*out*/);
+
+    /** Instruction from its serialized form.
+     *
+     *  Returns a new instruction at the specified address, or null if the data is malformed. */
+    static SgAsmInstruction* deserialize(const std::string&, rose_addr_t va);
+
+private:
+    bool insertSerialized(const Key&, const std::string&);
+};
+
+} // namespace
+} // namespace
+
+#endif
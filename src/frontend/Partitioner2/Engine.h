@@ -72,11 +72,14 @@ class Engine {
     bool opaquePredicateSearch_;                        // search for code opposite opaque predicate edges?
     bool postPartitionAnalyses_;                        // run various analyses after partitioning?
     bool useSemantics_;                                 // use instruction semantics
+    size_t nThreads_;                                   // threads for discovering basic blocks; zero means one per processor
+    size_t nBusyWorkers_;                               // most workers that discovered blocks in one batch during partitioning
+    DecodeCache::Ptr decodeCache_;                      // optional cache of decoded instructions for new partitioners
 public:
     Engine()
         : interp_(NULL), loader_(NULL), disassembler_(), basicBlockWorkList_(BasicBlockWorkList::instance()),
           dataMentionedFunctionSearch_(false), intraFunctionCodeSearch_(true), opaquePredicateSearch_(true),
-          postPartitionAnalyses_(true), useSemantics_(false) {}
+          postPartitionAnalyses_(true), useSemantics_(false), nThreads_(1), nBusyWorkers_(0) {}
 
     virtual ~Engine() {}
 
@@ -318,6 +321,38 @@ public:
     virtual void useSemantics(bool b) { useSemantics_ = b; }
     /** @} */
 
+    /** Property: number of threads.
+     *
+     *  Number of threads used by @ref discoverBasicBlocks to decode instructions and evaluate basic block semantics.  The
+     *  default, one, discovers one block at a time in the calling thread.  Any other value discovers blocks in batches with
+     *  @ref makeNextBasicBlocksFromPlaceholders, and zero means one thread per processor.  The basic blocks found in batches
+     *  do not depend on the number of threads, but they can differ from those found one at a time because the work list is
+     *  processed in a different order.  Discovery is always serial if ROSE's copy of %Sawyer was compiled without multi-thread
+     *  support (see SAWYER_MULTI_THREADED), since its locks are then no-ops.
+     *
+     * @{ */
+    size_t nThreads() const /*final*/ { return nThreads_; }
+    virtual void nThreads(size_t n) { nThreads_ = n; }
+    /** @} */
+
+    /** Number of threads that discovered basic blocks.
+     *
+     *  The largest number of threads that each discovered at least one basic block during a single batch of @ref
+     *  makeNextBasicBlocksFromPlaceholders since partitioning last started.  It is zero if no blocks were discovered in
+     *  parallel, and at most @ref nThreads. */
+    size_t nBusyWorkers() const /*final*/ { return nBusyWorkers_; }
+
+    /** Property: decode cache.
+     *
+     *  If non-null, partitioners created by this engine look up instructions in this cache before decoding them, and add the
+     *  instructions they decode to it.  A cache associated with a file lets later runs on the same or similar specimens skip
+     *  most decoding.  See @ref DecodeCache.
+     *
+     * @{ */
+    DecodeCache::Ptr decodeCache() const /*final*/ { return decodeCache_; }
+    virtual void decodeCache(const DecodeCache::Ptr &cache) { decodeCache_ = cache; }
+    /** @} */
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //                                  High-level methods that mostly call low-level stuff
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -340,7 +375,10 @@ public:
      *  Processes the "undiscovered" work list until the list becomes empty.  This list is the list of basic block placeholders
      *  for which no attempt has been made to discover instructions.  This method implements a recursive descent disassembler,
      *  although it does not process the control flow edges in any particular order. Subclasses are expected to override this
-     *  to implement a more directed approach to discovering basic blocks. */
+     *  to implement a more directed approach to discovering basic blocks.
+     *
+     *  If the @ref nThreads property is not one then the undiscovered work list is processed in batches by @ref
+     *  makeNextBasicBlocksFromPlaceholders. */
     virtual void discoverBasicBlocks(Partitioner&);
 
     /** Discover as many functions as possible.
@@ -394,6 +432,22 @@ public:
      *  into the "undiscovered" vertex. */
     virtual BasicBlock::Ptr makeNextBasicBlockFromPlaceholder(Partitioner&);
 
+    /** Discover basic blocks at all pending placeholders.
+     *
+     *  Takes every placeholder from the undiscovered work list and discovers their basic blocks speculatively in parallel,
+     *  using @ref nThreads threads, while the CFG and AUM are left unchanged.  The blocks are then attached to the partitioner
+     *  one at a time in the order in which @ref makeNextBasicBlockFromPlaceholder would have taken them from the work list.  A
+     *  block that would have been discovered differently because of blocks attached before it (because one of its
+     *  instructions is now a placeholder or belongs to another block) is discovered again before it's attached; this is
+     *  cheap since its instructions are already decoded.  Placeholders inserted by the attachments are left on the work list
+     *  for the next batch.
+     *
+     *  Basic block callbacks registered with the partitioner are invoked by the worker threads, but never by more than one
+     *  thread at a time, so they need not be thread safe.  They may be invoked for speculative blocks that are discarded and
+     *  discovered again.  If %Sawyer lacks multi-thread support then nothing is discovered speculatively and each block is
+     *  discovered as it is attached.  Returns the blocks that were attached, in the order they were attached. */
+    virtual std::vector<BasicBlock::Ptr> makeNextBasicBlocksFromPlaceholders(Partitioner&);
+
     /** Insert a call-return edge and discover its basic block.
      *
      *  Inserts a call-return (@ref E_CALL_RETURN) edge for some function call that lacks such an edge and for which the callee
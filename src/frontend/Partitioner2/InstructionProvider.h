@@ -3,10 +3,12 @@
 
 #include "Disassembler.h"
 #include "BaseSemantics2.h"
+#include "DecodeCache.h"
 
 #include <sawyer/Assert.h>
 #include <sawyer/Map.h>
 #include <sawyer/SharedPointer.h>
+#include <sawyer/Synchronization.h>
 
 namespace rose {
 namespace BinaryAnalysis {
@@ -22,7 +24,14 @@ namespace BinaryAnalysis {
  *  the user can initialize the cache explicitly and turn off the ability to call a disassembler.  A disassembler is always
  *  required regardless of whether its used to obtain new instructions because the disassembler has the canonical information
  *  about the machine architecture: what registers are defined, which registers are the program counter and stack pointer,
- *  which instruction semantics dispatcher can be used with the instructions, etc. */
+ *  which instruction semantics dispatcher can be used with the instructions, etc.
+ *
+ *  Instructions may be requested by several threads at once.  Disassemblers keep state while decoding, so a thread that
+ *  finds the supplied disassembler busy decodes with a private copy of it instead.
+ *
+ *  An optional @ref DecodeCache can be consulted before calling the disassembler. Instructions are rebuilt from the decode
+ *  cache when the same bytes were decoded at the same address earlier, possibly by an earlier run or for another specimen, and
+ *  newly decoded instructions are added to it. */
 class InstructionProvider: public Sawyer::SharedObject {
 public:
     typedef Sawyer::SharedPointer<InstructionProvider> Ptr;
@@ -33,14 +42,21 @@ private:
     MemoryMap memMap_;
     mutable InsnMap insnMap_;                           // this is a cache
     bool useDisassembler_;
+    mutable bool disassemblerBusy_;                     // disassembler_ is decoding an instruction
+    mutable std::vector<Disassembler*> idleClones_;     // copies of disassembler_ for concurrent decoding; owned
+    mutable SAWYER_THREAD_TRAITS::Mutex mutex_;         // protects insnMap_, disassemblerBusy_, and idleClones_
+    DecodeCache::Ptr decodeCache_;                      // optional persistent cache consulted before decoding
+    std::string isaName_;                               // name of disassembler_'s ISA in decodeCache_
 
 protected:
     InstructionProvider(Disassembler *disassembler, const MemoryMap &map)
-        : disassembler_(disassembler), memMap_(map), useDisassembler_(true) {
+        : disassembler_(disassembler), memMap_(map), useDisassembler_(true), disassemblerBusy_(false) {
         ASSERT_not_null(disassembler);
     }
 
 public:
+    ~InstructionProvider();
+
     /** Static allocating Constructor.
      *
      *  The disassembler is required even if the user plans to turn off the ability to obtain instructions from the
@@ -66,6 +82,21 @@ public:
     void disableDisassembler() { useDisassembler_ = false; }
     /** @} */
 
+    /** Property: decode cache.
+     *
+     *  When a decode cache is set, instructions that aren't in this provider's own cache are first looked up in the decode
+     *  cache, and only those not found there are obtained from the disassembler and then added to the decode cache.  The
+     *  decode cache can be shared by many instruction providers.  It should not be changed while other threads are obtaining
+     *  instructions from this provider.
+     *
+     * @{ */
+    DecodeCache::Ptr decodeCache() const { return decodeCache_; }
+    void decodeCache(const DecodeCache::Ptr &cache) {
+        decodeCache_ = cache;
+        isaName_ = cache ? DecodeCache::isaName(disassembler_) : std::string();
+    }
+    /** @} */
+
     /** Returns the instruction at the specified virtual address, or null.
      *
      *  If the virtual address is non-executable then a null pointer is returned, otherwise either a valid instruction or an
@@ -92,7 +123,10 @@ public:
      *  an instruction is known to not exist.
      *
      *  This is a constant-time operation. */
-    size_t nCached() const { return insnMap_.size(); }
+    size_t nCached() const {
+        SAWYER_THREAD_TRAITS::LockGuard lock(mutex_);
+        return insnMap_.size();
+    }
 
     /** Returns the register dictionary. */
     const RegisterDictionary* registerDictionary() const { return disassembler_->get_registers(); }
@@ -117,6 +151,11 @@ public:
      *  in which case a null pointer is returned.  The returned dispatcher is not connected to any semantic domain, so it can
      *  only be used to call its virtual constructor to create a valid dispatcher. */
     InstructionSemantics2::BaseSemantics::DispatcherPtr dispatcher() const { return disassembler_->dispatcher(); }
+
+private:
+    SgAsmInstruction* disassemble(Disassembler*, rose_addr_t va) const;
+    Disassembler* acquireDisassembler() const;
+    void releaseDisassembler(Disassembler*) const;
 };
 
 } // namespace
@@ -4,7 +4,13 @@
 #ifndef ASTATTRIBUTEMECHANISM_H
 #define ASTATTRIBUTEMECHANISM_H
 
+#include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <list>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "AttributeMechanism.h"
 #include "rosedll.h"
@@ -170,23 +176,274 @@ class ROSE_DLL_API MetricAttribute : public AstAttribute
 };
 
 
-// DQ (6/28/2008):
-// Since this is implemented using AttributeMechanism which is derived from
-// std::map<Key,Value>, "Value" is a template parameter for "AstAttribute*"
-// And so the copy constructor will copy the pointer.  This is OK, but it
-// means that the AstAttribute objects are shared.  Alternatively, a copy
-// constructor implemented in this class could be implemented to support
-// deep copies.  This might be a good idea.
-class AstAttributeMechanism : public AttributeMechanism<std::string,AstAttribute*>
+/** Container for the attributes attached to one IR node.
+ *
+ *  Attributes are named by strings, but each name is registered once in a global table that assigns it a small integer
+ *  ID, and a container stores only (ID, attribute) pairs in a small vector whose first couple of entries live inside the
+ *  container itself.  This keeps the per-node cost low when millions of nodes carry a few attributes each.  The string-based
+ *  interface is the same as it was when this class was a map from names to attributes; analyses that access attributes
+ *  frequently should look up the ID once with @ref attributeId (or use an @ref AstAttributeKey) and then use the ID-based
+ *  methods, which avoid string hashing and comparison altogether.  Each string-based call resolves its name to an ID once,
+ *  which is the only time it locks the global registry; keeping entries sorted and iterating read the registered names
+ *  without locking or copying them.
+ *
+ *  Iteration visits attributes in order of their names, and the iterator's value is a (name, attribute) pair.
+ *
+ *  The copy constructor makes a deep copy of the attributes by calling their virtual copy() methods, but the assignment
+ *  operator copies only the pointers so the attributes are shared.  The container never deletes attributes. */
+class ROSE_DLL_API AstAttributeMechanism
    {
      public:
+       //! Registered attribute name.
+          typedef unsigned AttributeId;
+
+       //! An ID that is never assigned to any name.
+          static const AttributeId INVALID_ID = (AttributeId)(-1);
+
+          typedef std::set<std::string> AttributeIdentifiers;
+
+       //! Forward iterator whose values are (name, attribute) pairs.  The name refers to the registered name, so
+       //! dereferencing an iterator neither copies the name nor locks the registry.
+          class const_iterator
+             {
+               const AstAttributeMechanism *mechanism_;
+               unsigned idx_;
+               public:
+                    struct value_type
+                       {
+                         const std::string &first;
+                         AstAttribute *second;
+                         value_type(const std::string &name, AstAttribute *attribute): first(name), second(attribute) {}
+                       };
+
+                 // Values are created when the iterator is dereferenced, so "pointers" hold a copy of one.
+                    class pointer
+                       {
+                         value_type value_;
+                         public:
+                              explicit pointer(const value_type &value): value_(value) {}
+                              const value_type* operator->() const { return &value_; }
+                       };
+
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef std::ptrdiff_t difference_type;
+                    typedef value_type reference;
+
+                    const_iterator(): mechanism_(NULL), idx_(0) {}
+                    const_iterator(const AstAttributeMechanism *mechanism, unsigned idx): mechanism_(mechanism), idx_(idx) {}
+                    reference operator*() const;
+                    pointer operator->() const { return pointer(**this); }
+                    const_iterator& operator++() { ++idx_; return *this; }
+                    const_iterator operator++(int) { const_iterator old = *this; ++idx_; return old; }
+                    bool operator==(const const_iterator &other) const { return mechanism_==other.mechanism_ && idx_==other.idx_; }
+                    bool operator!=(const const_iterator &other) const { return !(*this==other); }
+             };
+          typedef const_iterator iterator;
+          friend class const_iterator;
+
+          AstAttributeMechanism ();
+
        // DQ (7/27/2008): Build a copy constructor that will do a deep copy
        // instead of calling the default copy constructor.
           AstAttributeMechanism ( const AstAttributeMechanism & X );
 
-       // DQ (7/27/2008): Because we add an explicit copy constructor we
-       // now need an explicit default constructor.
-          AstAttributeMechanism ();
+          AstAttributeMechanism & operator= ( const AstAttributeMechanism & X );
+         ~AstAttributeMechanism ();
+
+       //! Returns the ID for an attribute name, registering the name if necessary.  IDs are never reused.
+          static AttributeId attributeId(const std::string &name);
+
+       //! Returns the name registered for an attribute ID.  The name never changes or moves, and looking it up takes no
+       //! lock.
+          static const std::string& attributeName(AttributeId id);
+
+       /* String-based interface. */
+
+       //! test if attribute "name" exists (i.e. has been added with add or set)
+          bool exists(const std::string &name) const;
+
+       //! add a new attribute. If attribute already exists, fail.
+          void add(const std::string &name, AstAttribute *data);
+
+       //! replace an existing attribute "name", fail if the attribute does not exist
+          void replace(const std::string &name, AstAttribute *data);
+
+       //! remove an existing attribute name, fail if the attribute does not exist
+          void remove(const std::string &name);
+
+       //! Set a value data for attribute name, adding it if it does not exist.
+          void set(const std::string &name, AstAttribute *data);
+
+       //! get the set of all attribute identifiers/names
+          AttributeIdentifiers getAttributeIdentifiers() const;
+
+       //! access the value of attribute "name". Fails if the attribute does not exist.
+          AstAttribute* operator[](const std::string &name) const;
+
+       //! Returns the attribute "name", or null if it does not exist.
+          AstAttribute* get(const std::string &name) const;
+
+       /* ID-based interface. */
+
+       //! Tests whether the attribute exists.
+          bool exists(AttributeId id) const
+             {
+               return find(id) != NULL;
+             }
+
+       //! Returns the attribute, or null if it does not exist.
+          AstAttribute* get(AttributeId id) const
+             {
+               const Entry *entry = find(id);
+               return entry ? entry->value : NULL;
+             }
+
+       //! Sets the attribute, adding it if it does not exist.
+          void set(AttributeId id, AstAttribute *data);
+
+       //! Removes the attribute if it exists.  Returns true if it existed.
+          bool erase(AttributeId id);
+
+       //! Number of attributes.
+          int size() const
+             {
+               return nEntries_;
+             }
+
+          const_iterator begin() const
+             {
+               return const_iterator(this, 0);
+             }
+          const_iterator end() const
+             {
+               return const_iterator(this, nEntries_);
+             }
+
+     private:
+          struct Entry
+             {
+               AttributeId id;
+               AstAttribute *value;
+             };
+
+       // Entries are sorted by attribute name so iteration order doesn't depend on the order in which names were registered.
+       // The first INLINE_CAPACITY entries are stored in the object; more are allocated on the heap.
+          enum { INLINE_CAPACITY = 2 };
+          unsigned nEntries_, capacity_;
+          union
+             {
+               Entry inline_[INLINE_CAPACITY];
+               Entry *heap_;
+             };
+
+          Entry* entries()
+             {
+               return capacity_ > INLINE_CAPACITY ? heap_ : inline_;
+             }
+          const Entry* entries() const
+             {
+               return capacity_ > INLINE_CAPACITY ? heap_ : inline_;
+             }
+          const Entry* find(AttributeId id) const
+             {
+               const Entry *e = entries();
+               for (unsigned i=0; i<nEntries_; ++i)
+                  {
+                    if (e[i].id == id)
+                         return e + i;
+                  }
+               return NULL;
+             }
+          Entry* find(AttributeId id)
+             {
+               return const_cast<Entry*>(const_cast<const AstAttributeMechanism*>(this)->find(id));
+             }
+          void insert(AttributeId id, AstAttribute *data);
+          void assign(const AstAttributeMechanism &other);
+   };
+
+/** Typed handle for a registered attribute name.
+ *
+ *  Declaring a key registers the name once; afterward the key reads and writes the attribute on any IR node that supports
+ *  attributes without string operations, and returns it already cast to the attribute type.  The attributes stored under
+ *  the key's name must have type @p T (or a subclass), whether they were stored through the key or through the string
+ *  interface.
+ *
+ * @code
+ *  static const AstAttributeKey<MetricAttribute> flopCount("flopCount");
+ *  flopCount.set(node, new MetricAttribute(42));
+ *  if (MetricAttribute *attr = flopCount.get(node))
+ *      ...
+ * @endcode */
+template<class T>
+class AstAttributeKey
+   {
+          AstAttributeMechanism::AttributeId id_;
+
+     public:
+          explicit AstAttributeKey(const std::string &name)
+             : id_(AstAttributeMechanism::attributeId(name))
+             {
+             }
+
+          AstAttributeMechanism::AttributeId id() const
+             {
+               return id_;
+             }
+
+          const std::string& name() const
+             {
+               return AstAttributeMechanism::attributeName(id_);
+             }
+
+       //! Attribute in a container, or null.
+          T* get(const AstAttributeMechanism *attributes) const
+             {
+               AstAttribute *attr = attributes ? attributes->get(id_) : NULL;
+               assert(attr == NULL || dynamic_cast<T*>(attr) != NULL);
+               return static_cast<T*>(attr);
+             }
+
+       //! Attribute of a node, or null.
+          template<class Node>
+          T* get(const Node *node) const
+             {
+               return get(node->get_attributeMechanism());
+             }
+
+       //! Tests whether a node has the attribute.
+          template<class Node>
+          bool exists(const Node *node) const
+             {
+               AstAttributeMechanism *attributes = node->get_attributeMechanism();
+               return attributes != NULL && attributes->exists(id_);
+             }
+
+       //! Sets the attribute of a node, creating the node's attribute container if necessary.
+          template<class Node>
+          void set(Node *node, T *value) const
+             {
+               AstAttributeMechanism *attributes = node->get_attributeMechanism();
+               if (attributes == NULL)
+                  {
+                    attributes = new AstAttributeMechanism();
+                    node->set_attributeMechanism(attributes);
+                  }
+               attributes->set(id_, value);
+             }
+
+       //! Removes the attribute from a node if present.  Like SgNode::removeAttribute, the node's attribute container is
+       //! deleted when its last attribute is removed.
+          template<class Node>
+          void remove(Node *node) const
+             {
+               AstAttributeMechanism *attributes = node->get_attributeMechanism();
+               if (attributes != NULL && attributes->erase(id_) && attributes->size() == 0)
+                  {
+                    delete attributes;
+                    node->set_attributeMechanism(NULL);
+                  }
+             }
    };
 
 
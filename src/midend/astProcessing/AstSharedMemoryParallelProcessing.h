@@ -69,6 +69,76 @@ private:
     size_t numberOfThreads;
 };
 
+#if defined(_REENTRANT) && defined(ROSE_HAVE_PTHREAD_H)    // user wants multi-thread support and POSIX threads are available?
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+// A fork/join task pool with one double-ended task queue per worker. A worker pushes and pops tasks at the back of its own
+// queue (LIFO, which keeps the working set of a subtree traversal in cache) and, when its own queue is empty, steals from the
+// front of another worker's queue (FIFO, which tends to steal the largest remaining subtrees). Worker zero is the thread
+// that created the pool; the other numberOfWorkers-1 workers are threads owned by the pool. A worker that waits for the
+// tasks it spawned executes other tasks in the meantime instead of blocking, and idle threads sleep on a condition variable
+// instead of busy-waiting.
+class AstSharedMemoryParallelTaskPool
+{
+public:
+    // Base class for tasks. The pool takes ownership of a task when it is spawned and deletes it after it has run.
+    class Task
+    {
+    public:
+        Task(): pending(NULL) {}
+        virtual ~Task() {}
+        // Called exactly once, by the worker whose index is given.
+        virtual void run(size_t worker) = 0;
+    private:
+        friend class AstSharedMemoryParallelTaskPool;
+        size_t *pending;                                // join counter decremented when the task finishes
+    };
+
+    explicit AstSharedMemoryParallelTaskPool(size_t numberOfWorkers);
+    ~AstSharedMemoryParallelTaskPool();
+
+    size_t numberOfWorkers() const;
+
+    // Adds a task to the queue of the specified worker (which must be the calling thread's worker index) and increments
+    // *pending; *pending is decremented when the task finishes.
+    void spawn(size_t worker, Task *task, size_t *pending);
+
+    // Returns when *pending is zero, executing queued tasks while waiting.
+    void waitFor(size_t worker, size_t *pending);
+
+    // Number of tasks executed by a worker, and how many of those were stolen from other workers.
+    size_t tasksExecuted(size_t worker) const;
+    size_t tasksStolen(size_t worker) const;
+
+private:
+    struct Worker
+    {
+        AstSharedMemoryParallelTaskPool *pool;
+        size_t id;
+        pthread_t thread;
+        pthread_mutex_t mutex;                          // protects tasks
+        std::deque<Task *> tasks;
+        size_t executed, stolen;                        // only modified by the worker itself
+    };
+
+    Task *takeTask(size_t worker);
+    void runTask(size_t worker, Task *);
+    static void *workerMain(void *);
+
+    // not implemented
+    AstSharedMemoryParallelTaskPool(const AstSharedMemoryParallelTaskPool &);
+    AstSharedMemoryParallelTaskPool &operator=(const AstSharedMemoryParallelTaskPool &);
+
+    std::vector<Worker *> workers;
+    pthread_mutex_t mutex;                              // protects queuedTasks, shutdown, and all join counters
+    pthread_cond_t changed;                             // broadcast when a task is spawned or finishes, or at shutdown
+    size_t queuedTasks;                                 // upper bound for the number of tasks in all queues
+    bool shutdown;
+};
+#endif
+
 // TOP DOWN BOTTOM UP parallel traversals
 
 // Class representing a traversal that can run in parallel with some other instances of the same type. It is basically a
@@ -126,15 +196,37 @@ public:
     SynthesizedAttributeTypeList *traverseInParallel(SgNode *basenode,
             InheritedAttributeTypeList *inheritedValue);
 
+    // Subtree-parallel mode: runs all traversals together (as traverse() does), but evaluates the subtrees rooted at nodes
+    // for which isParallelSubtree() is true as tasks on a work-stealing pool of numberOfThreads threads. Each node's
+    // synthesized attribute is evaluated after all its children's subtrees are done, so the result is the same as that of
+    // traverse() provided that the traversals' evaluate*Attribute() functions may be called concurrently for nodes in
+    // different parallel subtrees (i.e., the analyses have no cross-subtree dependencies). Nodes are always visited by
+    // index (custom setNodeSuccessors() implementations are not used). Unlike traverseInParallel(), this also speeds up a
+    // single traversal.
+    SynthesizedAttributeTypeList *traverseSubtreesInParallel(SgNode *basenode,
+            InheritedAttributeTypeList *inheritedValue);
+
     AstSharedMemoryParallelTopDownBottomUpProcessing();
     AstSharedMemoryParallelTopDownBottomUpProcessing(const TraversalPtrList &);
 
     void set_numberOfThreads(size_t threads) const;
     void set_synchronizationWindowSize(size_t windowSize) const;
 
+protected:
+    // Predicate selecting the roots of the subtrees that traverseSubtreesInParallel() processes as separate tasks. The
+    // default selects files and function definitions.
+    virtual bool isParallelSubtree(SgNode *node);
+
 private:
-    size_t numberOfThreads;
-    size_t synchronizationWindowSize;
+#if defined(_REENTRANT) && defined(ROSE_HAVE_PTHREAD_H)
+    template <class I, class S> friend class AstSharedMemoryParallelSubtreeTask;
+    SynthesizedAttributeTypeList *traverseSubtree(AstSharedMemoryParallelTaskPool &pool, size_t worker,
+            SgNode *node, InheritedAttributeTypeList *inheritedValues);
+#endif
+
+    // mutable because the setters are (for historical reasons) const member functions
+    mutable size_t numberOfThreads;
+    mutable size_t synchronizationWindowSize;
 };
 
 // TOP DOWN parallel traversals
@@ -197,8 +289,9 @@ public:
     void set_synchronizationWindowSize(size_t windowSize) const;
 
 private:
-    size_t numberOfThreads;
-    size_t synchronizationWindowSize;
+    // mutable because the setters are (for historical reasons) const member functions
+    mutable size_t numberOfThreads;
+    mutable size_t synchronizationWindowSize;
 };
 
 // BOTTOM UP parallel traversals
@@ -262,8 +355,9 @@ public:
     void set_synchronizationWindowSize(size_t windowSize) const;
 
 private:
-    size_t numberOfThreads;
-    size_t synchronizationWindowSize;
+    // mutable because the setters are (for historical reasons) const member functions
+    mutable size_t numberOfThreads;
+    mutable size_t synchronizationWindowSize;
 };
 
 #include "AstSharedMemoryParallelProcessingImpl.h"
@@ -229,6 +229,109 @@ AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::set_synchronizationWindo
 #endif
 }
 
+// Subtree-parallel TOP DOWN BOTTOM UP implementation
+
+template <class I, class S>
+bool
+AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::isParallelSubtree(SgNode *node)
+{
+    return isSgFile(node) != NULL || isSgFunctionDefinition(node) != NULL;
+}
+
+// A task that traverses one parallel subtree and stores the subtree's
+// synthesized attribute list in a slot of its parent's stack frame.
+template <class I, class S>
+class AstSharedMemoryParallelSubtreeTask: public AstSharedMemoryParallelTaskPool::Task
+{
+public:
+    typedef AstSharedMemoryParallelTopDownBottomUpProcessing<I, S> Processing;
+
+    AstSharedMemoryParallelSubtreeTask(Processing *processing, AstSharedMemoryParallelTaskPool &pool, SgNode *node,
+            typename Processing::InheritedAttributeTypeList *inheritedValues,
+            typename Processing::SynthesizedAttributeTypeList **result)
+        : processing(processing), pool(pool), node(node), inheritedValues(inheritedValues), result(result)
+    {
+    }
+
+    virtual void run(size_t worker)
+    {
+        *result = processing->traverseSubtree(pool, worker, node, inheritedValues);
+    }
+
+private:
+    Processing *processing;
+    AstSharedMemoryParallelTaskPool &pool;
+    SgNode *node;
+    typename Processing::InheritedAttributeTypeList *inheritedValues;
+    typename Processing::SynthesizedAttributeTypeList **result;
+};
+
+// The counterpart of SgTreeTraversal::performTraversal() for the subtree-parallel mode. Instead of the shared stack of
+// synthesized attributes, each node collects its children's attributes in a local vector whose slots for parallel subtrees
+// are filled in by tasks; the node waits for those tasks (helping with other work meanwhile) before its own synthesized
+// attribute is evaluated.
+template <class I, class S>
+typename AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::SynthesizedAttributeTypeList *
+AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::traverseSubtree(
+        AstSharedMemoryParallelTaskPool &pool, size_t worker, SgNode *node,
+        typename AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::InheritedAttributeTypeList *inheritedValues)
+{
+    inheritedValues = this->evaluateInheritedAttribute(node, inheritedValues);
+
+    size_t numberOfSuccessors = node->get_numberOfTraversalSuccessors();
+    std::vector<SynthesizedAttributeTypeList *> childResults(numberOfSuccessors, NULL);
+    size_t pending = 0;
+    for (size_t idx = 0; idx < numberOfSuccessors; idx++)
+    {
+        SgNode *child = node->get_traversalSuccessorByIndex(idx);
+        if (child == NULL)
+        {
+            childResults[idx] = this->defaultSynthesizedAttribute(inheritedValues);
+        }
+        else if (isParallelSubtree(child))
+        {
+            pool.spawn(worker,
+                    new AstSharedMemoryParallelSubtreeTask<I, S>(this, pool, child, inheritedValues, &childResults[idx]),
+                    &pending);
+        }
+        else
+        {
+            childResults[idx] = traverseSubtree(pool, worker, child, inheritedValues);
+        }
+    }
+    pool.waitFor(worker, &pending);
+
+    typename Superclass::SynthesizedAttributesList synthesizedAttributes(numberOfSuccessors);
+    for (size_t idx = 0; idx < numberOfSuccessors; idx++)
+        synthesizedAttributes[idx] = childResults[idx];
+
+    // evaluateSynthesizedAttribute() frees the children's lists and our inheritedValues
+    return this->evaluateSynthesizedAttribute(node, inheritedValues, synthesizedAttributes);
+}
+
+template <class I, class S>
+typename AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::SynthesizedAttributeTypeList *
+AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::traverseSubtreesInParallel(
+        SgNode *basenode,
+        typename AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::InheritedAttributeTypeList *inheritedValues)
+{
+    ROSE_ASSERT(basenode != NULL);
+    ROSE_ASSERT(inheritedValues != NULL);
+    ROSE_ASSERT(inheritedValues->size() == Superclass::traversals.size());
+
+    this->atTraversalStart();
+
+    SynthesizedAttributeTypeList *result = NULL;
+    {
+        // The calling thread is worker zero; the pool's threads are joined when it goes out of scope.
+        AstSharedMemoryParallelTaskPool pool(numberOfThreads > 0 ? numberOfThreads : 1);
+        result = traverseSubtree(pool, 0, basenode, inheritedValues);
+    }
+
+    this->atTraversalEnd();
+    return result;
+}
+
 // parallel TOP DOWN implementation
 
 template <class I>
@@ -416,6 +416,18 @@ template<typename NodeFunctional>
   template <class FunctionalType> 
     void queryMemoryPool(AstQuery<ROSE_VisitTraversal,FunctionalType>& astQuery, VariantVector* variantsToTraverse);
 
+  /****************************************************************************
+   * The function
+   *  void buildMemoryPoolTable(MemoryPoolTable& table);
+   * calls table.add(variant, numberOfBlocks, collectBlockNodes) once for every
+   * IR node class, passing the static numberOfMemoryPoolBlocks() and
+   * collectMemoryPoolBlockNodes() member functions of that class. It is
+   * generated by ROSETTA along with queryMemoryPool().
+   ***************************************************************************/
+
+  template <class MemoryPoolTable>
+    void buildMemoryPoolTable(MemoryPoolTable& table);
+
   /********************************************************************************
    * The function
    *      std::list<ListElement> querySubTree<ListElement>(SgNode* node, Predicate& _pred)
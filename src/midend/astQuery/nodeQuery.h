@@ -429,6 +429,69 @@ namespace NodeQuery
   queryMemoryPool(VariantVector& targetVariantVector);
 
 
+/********************************************************************************
+ * The class MemoryPoolQueryResult holds the result of queryMemoryPoolInParallel().
+ * All nodes are stored in a single contiguous array, grouped by variant and, within
+ * a variant, in memory pool order (the same order as queryMemoryPool()). The nodes
+ * of a variant or of a whole VariantVector can be accessed without copying the
+ * array, so one result can answer many queries.
+ ********************************************************************************/
+  class ROSE_DLL_API MemoryPoolQueryResult
+  {
+    public:
+      typedef SgNode* const* const_iterator;
+
+      MemoryPoolQueryResult();
+
+      //! Total number of nodes in the result.
+      size_t size() const { return nodes.size(); }
+      const_iterator begin() const { return nodes.empty() ? NULL : &nodes[0]; }
+      const_iterator end() const { return begin() + nodes.size(); }
+
+      //! True if the memory pool of this variant was scanned by the query.
+      bool contains(VariantT variant) const;
+
+      //! Nodes of exactly this variant (an empty range if the variant was not scanned).
+      size_t size(VariantT variant) const;
+      const_iterator begin(VariantT variant) const;
+      const_iterator end(VariantT variant) const;
+
+      //! Number of nodes whose variant is in the VariantVector.
+      size_t count(const VariantVector& variants) const;
+
+      //! Appends the nodes whose variant is in the VariantVector, in VariantVector order.
+      void collect(const VariantVector& variants, Rose_STL_Container<SgNode*>& result) const;
+
+    private:
+      friend MemoryPoolQueryResult queryMemoryPoolInParallel(const std::vector<VariantVector>&, size_t);
+
+      std::vector<SgNode*> nodes;
+
+      // Indexed by variant: [first, second) is the range of "nodes" for that variant, or
+      // (npos, npos) if that variant was not scanned.
+      std::vector<std::pair<size_t, size_t> > ranges;
+  };
+
+/********************************************************************************
+ * The function
+ *      MemoryPoolQueryResult queryMemoryPoolInParallel(const VariantVector& targetVariantVector,
+ *                                                      size_t nThreads = 0);
+ * returns every node in the memory pools with a corresponding variant in the VariantVector.
+ * The memory pools are split into blocks which are scanned by nThreads threads (zero means
+ * use the hardware concurrency). The result is the same as queryMemoryPool(VariantVector&),
+ * but no IR nodes may be created or deleted while the query runs.
+ *
+ * The second form answers several queries with one scan: each variant is scanned only once
+ * no matter how many of the VariantVectors contain it, and the nodes of any one query can
+ * then be obtained with MemoryPoolQueryResult::collect().
+ ********************************************************************************/
+  ROSE_DLL_API MemoryPoolQueryResult
+  queryMemoryPoolInParallel(const VariantVector& targetVariantVector, size_t nThreads = 0);
+
+  ROSE_DLL_API MemoryPoolQueryResult
+  queryMemoryPoolInParallel(const std::vector<VariantVector>& targetVariantVectors, size_t nThreads = 0);
+
+
 // END NAMESPACE NodeQuery2
 }
 
@@ -7,7 +7,9 @@
 
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <list>
+#include <set>
 #include <sawyer/GraphTraversal.h>
 #include <sawyer/DistinctList.h>
 #include <sstream>
@@ -242,7 +244,16 @@ public:
      *      new state which is a copy of the argument.
      *
      *  The control flow graph and transfer function are specified in the engine's constructor.  The starting CFG vertex and
-     *  its initial state are supplied when the engine starts to run. */
+     *  its initial state are supplied when the engine starts to run.
+     *
+     *  Vertices are taken from the work list in reverse postorder of a depth-first traversal from the starting vertex, so that
+     *  (loops aside) a vertex is visited only after all of its predecessors have been visited.  This usually reaches the
+     *  fixed point in fewer iterations than visiting vertices in the order they were added to the work list.
+     *
+     *  By default the engine stores an incoming and outgoing state for every vertex. If the @ref sparseStates property is set
+     *  then it stores only the incoming states of the starting vertex and of vertices having more than one incoming edge
+     *  (which includes all loop heads).  The states for the other vertices are recomputed by the transfer function when they're
+     *  needed, which trades time for memory when analyzing large control flow graphs. */
     template<class CFG, class StatePtr, class TransferFunction>
     class Engine {
         const CFG &cfg_;
@@ -250,10 +261,14 @@ public:
         typedef std::vector<StatePtr> VertexStates;
         VertexStates incomingState_;                    // incoming data flow state per CFG vertex ID
         VertexStates outgoingState_;                    // outgoing data flow state per CFG vertex ID
-        typedef Sawyer::Container::DistinctList<size_t> WorkList;
-        WorkList workList_;                             // CFG vertex IDs to be visited, last in first out w/out duplicates
+        typedef std::set<size_t> WorkList;
+        WorkList workList_;                             // reverse postorder numbers of CFG vertices to be visited
+        std::vector<size_t> order_;                     // CFG vertex IDs in reverse postorder from the starting vertex
+        std::vector<size_t> rank_;                      // position of each CFG vertex ID in order_
+        std::vector<bool> isStored_;                    // whether the incoming state of each vertex is stored when sparse
         size_t maxIterations_;                          // max number of iterations to allow
         size_t nIterations_;                            // number of iterations since last reset
+        bool sparseStates_;                             // store only states at join points (and start vertex)?
 
     public:
         /** Constructor.
@@ -262,12 +277,13 @@ public:
          *  transfer function.  The control flow graph is incorporated into the engine by reference; the transfer functor is
          *  copied. */
         Engine(const CFG &cfg, TransferFunction &xfer)
-            : cfg_(cfg), xfer_(xfer), maxIterations_(-1), nIterations_(0) {}
+            : cfg_(cfg), xfer_(xfer), maxIterations_(-1), nIterations_(0), sparseStates_(false) {}
 
         /** Reset engine to initial state.
          *
          *  This happens automatically by methods such as @ref runToFixedPoint. */
         void reset(size_t startVertexId, const StatePtr &initialState) {
+            using namespace Sawyer::Container::Algorithm;
             ASSERT_this();
             ASSERT_require(startVertexId < cfg_.nVertices());
             ASSERT_not_null(initialState);
@@ -276,8 +292,27 @@ public:
             incomingState_[startVertexId] = initialState;
             outgoingState_.clear();
             outgoingState_.resize(cfg_.nVertices());
+
+            // Number the vertices reachable from the start in reverse postorder. Unreachable vertices never enter the work list.
+            order_.clear();
+            rank_.clear();
+            rank_.resize(cfg_.nVertices(), cfg_.nVertices());
+            typedef DepthFirstForwardGraphTraversal<const CFG> Traversal;
+            for (Traversal t(cfg_, cfg_.findVertex(startVertexId), LEAVE_VERTEX); t; ++t)
+                order_.push_back(t.vertex()->id());
+            std::reverse(order_.begin(), order_.end());
+            for (size_t i=0; i<order_.size(); ++i)
+                rank_[order_[i]] = i;
+
+            isStored_.clear();
+            isStored_.resize(cfg_.nVertices(), true);
+            if (sparseStates_) {
+                BOOST_FOREACH (const typename CFG::VertexNode &vertex, cfg_.vertices())
+                    isStored_[vertex.id()] = vertex.id() == startVertexId || vertex.nInEdges() > 1;
+            }
+
             workList_.clear();
-            workList_.pushBack(startVertexId);
+            workList_.insert(rank_[startVertexId]);
             nIterations_ = 0;
         }
 
@@ -291,6 +326,21 @@ public:
         void maxIterations(size_t n) { maxIterations_ = n; }
         /** @} */
 
+        /** Whether to store states only at join points.
+         *
+         *  When set, only the incoming states of the starting vertex and of vertices with more than one incoming edge are
+         *  stored, and only those vertices are placed on the work list. Each iteration runs the transfer function on such a
+         *  vertex and then, without storing their states, on the successors that have no other incoming edge, and so on
+         *  until it reaches vertices whose states are stored.  Every cycle contains a vertex with a stored state, so this
+         *  always terminates.  @ref getInitialState and @ref getFinalState recompute the states of the other vertices from
+         *  the nearest stored state, so the transfer function must be deterministic.  Changing this property takes effect at
+         *  the next @ref reset.
+         *
+         * @{ */
+        bool sparseStates() const { return sparseStates_; }
+        void sparseStates(bool b) { sparseStates_ = b; }
+        /** @} */
+
         /** Number of iterations run.
          *
          *  The number of times runOneIteration was called since the last reset. */
@@ -302,62 +352,80 @@ public:
          *  work list is empty (before of after the iteration). */
         bool runOneIteration() {
             using namespace Diagnostics;
-            if (!workList_.isEmpty()) {
+            if (!workList_.empty()) {
                 if (++nIterations_ > maxIterations_) {
                     throw std::runtime_error("dataflow max iterations reached"
                                              " (max=" + StringUtility::numberToString(maxIterations_) + ")");
                 }
-                size_t cfgVertexId = workList_.popFront();
+                size_t cfgVertexId = order_[*workList_.begin()];
+                workList_.erase(workList_.begin());
                 if (mlog[DEBUG]) {
                     mlog[DEBUG] <<"runOneIteration: vertex #" <<cfgVertexId <<"\n";
                     mlog[DEBUG] <<"  remaining worklist is {";
-                    BOOST_FOREACH (size_t id, workList_.items())
-                        mlog[DEBUG] <<" " <<id;
+                    BOOST_FOREACH (size_t rank, workList_)
+                        mlog[DEBUG] <<" " <<order_[rank];
                     mlog[DEBUG] <<" }\n";
                 }
-                
+
                 ASSERT_require2(cfgVertexId < cfg_.nVertices(),
                                 "vertex " + boost::lexical_cast<std::string>(cfgVertexId) + " must be valid within CFG");
-                typename CFG::ConstVertexNodeIterator vertex = cfg_.findVertex(cfgVertexId);
                 StatePtr state = incomingState_[cfgVertexId];
                 ASSERT_not_null2(state,
                                  "initial state must exist for CFG vertex " + boost::lexical_cast<std::string>(cfgVertexId));
-                if (mlog[DEBUG]) {
-                    std::ostringstream ss;
-                    ss <<*state;
-                    mlog[DEBUG] <<"  incoming state for vertex #" <<cfgVertexId <<"\n";
-                    mlog[DEBUG] <<StringUtility::prefixLines(ss.str(), "    ");
-                }
 
-                state = outgoingState_[cfgVertexId] = xfer_(cfg_, cfgVertexId, state);
-                ASSERT_not_null2(state, "outgoing state not created for vertex "+boost::lexical_cast<std::string>(cfgVertexId));
-                if (mlog[DEBUG]) {
-                    std::ostringstream ss;
-                    ss <<*state;
-                    mlog[DEBUG] <<"  outgoing state for vertex #" <<cfgVertexId <<"\n";
-                    mlog[DEBUG] <<StringUtility::prefixLines(ss.str(), "    ");
-                }
-                
-                // Outgoing state must be merged into the incoming states for the CFG successors.  Any such incoming state that
-                // is modified as a result will have its CFG vertex added to the work list.
-                SAWYER_MESG(mlog[DEBUG]) <<"  forwarding vertex #" <<cfgVertexId <<" output state to "
-                                         <<StringUtility::plural(vertex->nOutEdges(), "vertices", "vertex") <<"\n";
-                BOOST_FOREACH (const typename CFG::EdgeNode &edge, vertex->outEdges()) {
-                    size_t nextVertexId = edge.target()->id();
-                    StatePtr targetState = incomingState_[nextVertexId];
-                    if (targetState==NULL) {
-                        SAWYER_MESG(mlog[DEBUG]) <<"    forwarded to vertex #" <<nextVertexId <<"\n";
-                        incomingState_[nextVertexId] = xfer_(state); // copy the state
-                        workList_.pushBack(nextVertexId);
-                    } else if (targetState->merge(state)) {
-                        SAWYER_MESG(mlog[DEBUG]) <<"    merged with vertex #" <<nextVertexId <<" (which changed as a result)\n";
-                        workList_.pushBack(nextVertexId);
-                    } else {
-                        SAWYER_MESG(mlog[DEBUG]) <<"     merged with vertex #" <<nextVertexId <<" (no change)\n";
+                // Vertices whose states are not stored are processed as soon as their only predecessor is.
+                std::vector<std::pair<size_t, StatePtr> > pending(1, std::make_pair(cfgVertexId, state));
+                while (!pending.empty()) {
+                    cfgVertexId = pending.back().first;
+                    state = pending.back().second;
+                    pending.pop_back();
+                    typename CFG::ConstVertexNodeIterator vertex = cfg_.findVertex(cfgVertexId);
+                    if (mlog[DEBUG]) {
+                        std::ostringstream ss;
+                        ss <<*state;
+                        mlog[DEBUG] <<"  incoming state for vertex #" <<cfgVertexId <<"\n";
+                        mlog[DEBUG] <<StringUtility::prefixLines(ss.str(), "    ");
+                    }
+
+                    state = xfer_(cfg_, cfgVertexId, state);
+                    ASSERT_not_null2(state,
+                                     "outgoing state not created for vertex "+boost::lexical_cast<std::string>(cfgVertexId));
+                    if (!sparseStates_)
+                        outgoingState_[cfgVertexId] = state;
+                    if (mlog[DEBUG]) {
+                        std::ostringstream ss;
+                        ss <<*state;
+                        mlog[DEBUG] <<"  outgoing state for vertex #" <<cfgVertexId <<"\n";
+                        mlog[DEBUG] <<StringUtility::prefixLines(ss.str(), "    ");
+                    }
+
+                    // Outgoing state must be merged into the incoming states for the CFG successors.  Any such incoming state
+                    // that is modified as a result will have its CFG vertex added to the work list.
+                    SAWYER_MESG(mlog[DEBUG]) <<"  forwarding vertex #" <<cfgVertexId <<" output state to "
+                                             <<StringUtility::plural(vertex->nOutEdges(), "vertices", "vertex") <<"\n";
+                    BOOST_FOREACH (const typename CFG::EdgeNode &edge, vertex->outEdges()) {
+                        size_t nextVertexId = edge.target()->id();
+                        if (!isStored_[nextVertexId]) {
+                            SAWYER_MESG(mlog[DEBUG]) <<"    forwarded to unstored vertex #" <<nextVertexId <<"\n";
+                            pending.push_back(std::make_pair(nextVertexId, xfer_(state))); // copy the state
+                            continue;
+                        }
+                        StatePtr targetState = incomingState_[nextVertexId];
+                        if (targetState==NULL) {
+                            SAWYER_MESG(mlog[DEBUG]) <<"    forwarded to vertex #" <<nextVertexId <<"\n";
+                            incomingState_[nextVertexId] = xfer_(state); // copy the state
+                            workList_.insert(rank_[nextVertexId]);
+                        } else if (targetState->merge(state)) {
+                            SAWYER_MESG(mlog[DEBUG]) <<"    merged with vertex #" <<nextVertexId
+                                                     <<" (which changed as a result)\n";
+                            workList_.insert(rank_[nextVertexId]);
+                        } else {
+                            SAWYER_MESG(mlog[DEBUG]) <<"     merged with vertex #" <<nextVertexId <<" (no change)\n";
+                        }
                     }
                 }
             }
-            return !workList_.isEmpty();
+            return !workList_.empty();
         }
         
         /** Run data flow until it reaches a fixed point.
@@ -369,22 +437,59 @@ public:
             while (runOneIteration()) /*void*/;
         }
 
-        /** Return the initial state for the specified CFG vertex. */
+        /** Return the initial state for the specified CFG vertex.
+         *
+         *  When only sparse states are stored, the state of a vertex without a stored state is recomputed from the nearest
+         *  predecessor with a stored state. */
         StatePtr getInitialState(size_t cfgVertexId) const {
-            return incomingState_[cfgVertexId];
+            ASSERT_require(cfgVertexId < cfg_.nVertices());
+            if (isStored_.empty() || isStored_[cfgVertexId])
+                return incomingState_[cfgVertexId];
+
+            if (rank_[cfgVertexId] >= order_.size())
+                return StatePtr();                      // not reachable from the starting vertex
+
+            // Follow the chain of only-predecessors back to a vertex whose state is stored
+            std::vector<size_t> chain;
+            size_t id = cfgVertexId;
+            while (!isStored_[id]) {
+                typename CFG::ConstVertexNodeIterator vertex = cfg_.findVertex(id);
+                ASSERT_require(vertex->nInEdges() == 1);
+                id = vertex->inEdges().begin()->source()->id();
+                chain.push_back(id);
+            }
+
+            // Run the transfer function forward along the chain
+            StatePtr state = incomingState_[id];
+            for (size_t i=chain.size(); i>0 && state!=NULL; --i)
+                state = xfer_(cfg_, chain[i-1], state);
+            return state;
         }
 
-        /** Return the final state for the specified CFG vertex.  Users call this to get the results. */
+        /** Return the final state for the specified CFG vertex.  Users call this to get the results.
+         *
+         *  When only sparse states are stored, the state is recomputed from the vertex's initial state. */
         StatePtr getFinalState(size_t cfgVertexId) const {
-            return outgoingState_[cfgVertexId];
+            ASSERT_require(cfgVertexId < cfg_.nVertices());
+            if (!sparseStates_ || isStored_.empty())
+                return outgoingState_[cfgVertexId];
+            StatePtr state = getInitialState(cfgVertexId);
+            return state==NULL ? state : xfer_(cfg_, cfgVertexId, state);
         }
 
+        /** All initial and final states indexed by CFG vertex ID.
+         *
+         *  When only sparse states are stored, the initial states are present only for the vertices that store them and the
+         *  final states are all null; use @ref getInitialState and @ref getFinalState instead.
+         *
+         * @{ */
         const VertexStates& getInitialStates() const {
             return incomingState_;
         }
         const VertexStates& getFinalStates() const {
             return outgoingState_;
         }
+        /** @} */
     };
 };
 
@@ -1542,7 +1542,7 @@ public:
     };
 
     /** Visit each memory cell. */
-    void traverse(Visitor &visitor);
+    virtual void traverse(Visitor &visitor);
 
     /** Returns the list of all memory cells.
      * @{ */
@@ -7,11 +7,13 @@
 
 #include "Map.h"
 
+#include <boost/unordered_map.hpp>
 #include <cassert>
 #include <inttypes.h>
 #include <sawyer/BitVector.h>
 #include <sawyer/SharedPointer.h>
 #include <sawyer/SmallObject.h>
+#include <sawyer/Synchronization.h>
 #include <set>
 #include <vector>
 
@@ -84,6 +86,7 @@ const char *to_str(Operator o);
 class TreeNode;
 class InternalNode;
 class LeafNode;
+class InternTable;
 
 typedef Sawyer::SharedPointer<const TreeNode> TreeNodePtr;
 typedef Sawyer::SharedPointer<const InternalNode> InternalNodePtr;
@@ -135,12 +138,18 @@ public:
  *  For convenience, we define TreeNodePtr, InternalNodePtr, and LeafNodePtr typedefs.  The pointers themselves collectively
  *  own the pointer to the tree node and thus the tree node pointer should never be deleted explicitly. */
 class TreeNode: public Sawyer::SharedObject, public Sawyer::SharedFromThis<TreeNode>, public Sawyer::SmallObject {
+    friend class InternTable;
 protected:
     size_t nbits;               /**< Number of significant bits. Constant over the life of the node. */
     mutable std::string comment; /**< Optional comment. Only for debugging; not significant for any calculation. */
     mutable uint64_t hashval;   /**< Optional hash used as a quick way to indicate that two expressions are different. */
+    mutable uint64_t intern_generation; /**< Generation of the InternTable that holds this node, or zero. */
+    mutable uint64_t intern_hash; /**< Structural hash computed by the InternTable; valid if intern_generation is set. */
 public:
-    TreeNode(size_t nbits, std::string comment=""): nbits(nbits), comment(comment), hashval(0) { ASSERT_require(nbits>0); }
+    TreeNode(size_t nbits, std::string comment="")
+        : nbits(nbits), comment(comment), hashval(0), intern_generation(0), intern_hash(0) {
+        ASSERT_require(nbits>0);
+    }
 
     /** Returns true if two expressions must be equal (cannot be unequal).  If an SMT solver is specified then that solver is
      * used to answer this question, otherwise equality is established by looking only at the structure of the two
@@ -226,6 +235,10 @@ public:
      *  is computed and cached. */
     uint64_t hash() const;
 
+    /** Returns true if this node is held by an intern table.  Two different nodes held by the same table are never
+     *  structurally equivalent. See InternTable. */
+    bool is_interned() const { return intern_generation!=0; }
+
     /** A node with formatter. See the with_format() method. */
     class WithFormatter {
     private:
@@ -399,11 +412,111 @@ struct MssbSimplifier: Simplifier {
     virtual TreeNodePtr rewrite(const InternalNode*) const ROSE_OVERRIDE;
 };
 
+/** Table of unique expressions (hash consing).
+ *
+ *  While an intern table is current, every expression created by InternalNode::create, LeafNode::create_integer, and
+ *  LeafNode::create_constant is looked up in the table and the node already in the table is returned if there is one.
+ *  Structurally equivalent expressions therefore share a single node, and since the children of an interned node are also
+ *  interned, the lookup compares children by pointer instead of walking the trees.  Two nodes from the same table are
+ *  equivalent only if they are the same node, which makes TreeNode::equivalent_to (and thus must_equal and may_equal when no
+ *  SMT solver is needed) a pointer comparison for them.  Variables and memory states are unique by construction and are not
+ *  stored in the table.
+ *
+ *  Comments are not significant for equivalence, so a created node may come back with the comment of the node that was
+ *  interned first, and changing the comment of an interned node changes it for all expressions that share the node.
+ *
+ *  A table holds a reference to each of its nodes.  Nodes no longer used outside the table are released by @ref purge, which
+ *  the table also calls itself whenever it has doubled in size since the previous purge, and all nodes are released by @ref
+ *  clear.  Nodes that were created when no table (or another table) was current are copied into the table when they become
+ *  children of new expressions.  A table may be used by several threads at once, but the current table should be changed
+ *  only while no thread is creating expressions.
+ *
+ *  No table is current by default.  An analysis typically uses a table of its own for its lifetime:
+ *
+ *  @code
+ *   InternTable::Ptr table = InternTable::instance();
+ *   InternTable::Scope scope(table);   // table is current until scope is destroyed
+ *   ... run the analysis ...
+ *  @endcode */
+class InternTable: public Sawyer::SharedObject {
+public:
+    typedef Sawyer::SharedPointer<InternTable> Ptr;
+
+    /** Makes a table current for the lifetime of this object, then restores the table that was current before. */
+    class Scope {
+        Ptr saved_;
+    public:
+        explicit Scope(const Ptr &table): saved_(current()) { current(table); }
+        ~Scope() { current(saved_); }
+    };
+
+private:
+    typedef boost::unordered_map<uint64_t, TreeNodes> Buckets;
+    typedef std::map<const TreeNode*, TreeNodePtr> Copies;
+
+    mutable SAWYER_THREAD_TRAITS::Mutex mutex_;         // protects all data members
+    Buckets buckets_;                                   // interned nodes by structural hash
+    uint64_t generation_;                               // stamped into each interned node; changed by clear()
+    size_t size_;                                       // number of interned nodes
+    size_t purge_size_;                                 // purge when size_ reaches this
+    size_t nhits_, nmisses_;                            // statistics
+
+    static Ptr current_;                                // current table, if any
+    static InternTable *current_raw_;                   // current_.getRawPointer(), read without locking
+
+protected:
+    InternTable();
+
+public:
+    /** Allocating constructor. */
+    static Ptr instance() { return Ptr(new InternTable); }
+
+    /** Property: current table.
+     *
+     *  The table used by the expression creation functions, or null if expressions are not interned.
+     *
+     * @{ */
+    static Ptr current() { return current_; }
+    static void current(const Ptr &table);
+    /** @} */
+
+    /** Interns an expression in the current table.  Returns @p node unchanged if no table is current. */
+    static TreeNodePtr intern_current(const TreeNodePtr &node) {
+        return current_raw_ ? current_raw_->intern(node) : node;
+    }
+
+    /** Returns the node of this table that is equivalent to @p node, adding @p node (or a copy of it) if there is none. */
+    TreeNodePtr intern(const TreeNodePtr &node);
+
+    /** Releases nodes that are referenced only by this table.  Returns the number of nodes released. */
+    size_t purge();
+
+    /** Releases all nodes.  Nodes that remain in use are no longer considered interned. */
+    void clear();
+
+    /** Number of nodes in the table. */
+    size_t size() const;
+
+    /** Number of lookups that found an existing node and number of lookups that added a node.
+     * @{ */
+    size_t nhits() const;
+    size_t nmisses() const;
+    /** @} */
+
+private:
+    TreeNodePtr intern(const TreeNodePtr &node, Copies &copies);
+    uint64_t structural_hash(const TreeNodePtr&) const;
+    bool is_canonical(const TreeNodePtr&) const;
+    static bool is_same(const TreeNodePtr &a, const TreeNodePtr &b);
+    size_t purge_unlocked();
+};
+
 /** Internal node of an expression tree for instruction semantics. Each internal node has an operator (constant for the life of
  *  the node and obtainable with get_operator()) and zero or more children. Children are added to the internal node during the
  *  construction phase. Once construction is complete, the children should only change in ways that don't affect the value of
  *  the node as a whole (since this node might be pointed to by any number of expressions). */
 class InternalNode: public TreeNode {
+    friend class InternTable;
 private:
     Operator op;
     TreeNodes children;
@@ -442,25 +555,25 @@ public:
      *  @{ */
     static TreeNodePtr create(size_t nbits, Operator op, const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, comment));
-        return retval->simplifyTop();
+        return InternTable::intern_current(retval->simplifyTop());
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodePtr &a, const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, a, comment));
-        return retval->simplifyTop();
+        return InternTable::intern_current(retval->simplifyTop());
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodePtr &a, const TreeNodePtr &b,
                                   const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, a, b, comment));
-        return retval->simplifyTop();
+        return InternTable::intern_current(retval->simplifyTop());
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodePtr &a, const TreeNodePtr &b, const TreeNodePtr &c,
                                   const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, a, b, c, comment));
-        return retval->simplifyTop();
+        return InternTable::intern_current(retval->simplifyTop());
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodes &children, const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, children, comment));
-        return retval->simplifyTop();
+        return InternTable::intern_current(retval->simplifyTop());
     }
     /** @} */
 
@@ -540,6 +653,7 @@ protected:
  *
  *  A leaf node is either a known bit vector value, a free bit vector variable, or a memory state. */
 class LeafNode: public TreeNode {
+    friend class InternTable;
 private:
     enum LeafType { CONSTANT, BITVECTOR, MEMORY };
     LeafType leaf_type;
@@ -551,6 +665,9 @@ private:
 
     static uint64_t name_counter;
 
+    // Returns the next unused name. Leaf nodes may be created by several threads at once.
+    static uint64_t next_name();
+
 public:
     /** Construct a new free variable with a specified number of significant bits. */
     static LeafNodePtr create_variable(size_t nbits, std::string comment="");
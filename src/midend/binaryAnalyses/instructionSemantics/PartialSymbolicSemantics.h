@@ -43,6 +43,9 @@ namespace PartialSymbolicSemantics {
 
     extern uint64_t name_counter;
 
+    /** Returns the next unused variable name.  Values may be created by several threads at once. */
+    uint64_t next_name();
+
     /** Formatter that renames variables on the fly.  When this formatter is used, named variables are renamed using
      *  lower numbers. This is useful for human-readable output because variable names tend to get very large (like
      *  "v904885611"). */
@@ -73,7 +76,7 @@ namespace PartialSymbolicSemantics {
                                              *    constants. */
 
         /** Construct a value that is unknown and unique. */
-        ValueType(): name(++name_counter), offset(0), negate(false) {}
+        ValueType(): name(next_name()), offset(0), negate(false) {}
 
         /** Copy-construct a value, truncating or extending at msb the source value. */
         template <size_t Len>
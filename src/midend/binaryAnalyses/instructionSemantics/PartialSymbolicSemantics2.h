@@ -42,6 +42,9 @@ namespace PartialSymbolicSemantics {
 
 extern uint64_t name_counter;
 
+/** Returns the next unused variable name.  Values may be created by several threads at once. */
+uint64_t next_name();
+
 /*******************************************************************************************************************************
  *                                      Print Formatter
  *******************************************************************************************************************************/
@@ -77,14 +80,14 @@ public:
     // Real constructors
 protected:
     explicit SValue(size_t nbits)
-        : BaseSemantics::SValue(nbits), name(++name_counter), offset(0), negate(false) {}
+        : BaseSemantics::SValue(nbits), name(next_name()), offset(0), negate(false) {}
 
     SValue(size_t nbits, uint64_t number)
         : BaseSemantics::SValue(nbits), name(0), offset(number), negate(false) {
         if (nbits <= 64) {
             this->offset &= IntegerOps::genMask<uint64_t>(nbits);
         } else {
-            name = ++name_counter;
+            name = next_name();
             offset = 0;
         }
     }
@@ -9,6 +9,7 @@
 #include "threadSupport.h"
 
 #include <inttypes.h>
+#include <map>
 
 namespace rose {
 namespace BinaryAnalysis {
@@ -34,15 +35,72 @@ public:
 
     /** SMT solver statistics. */
     struct Stats {
-        Stats(): ncalls(0), input_size(0), output_size(0) {}
+        Stats(): ncalls(0), input_size(0), output_size(0), ncache_hits(0) {}
         size_t ncalls;                          /**< Number of times satisfiable() was called. */
         size_t input_size;                      /**< Bytes of input generated for satisfiable(). */
         size_t output_size;                     /**< Amount of output produced by the SMT solver. */
+        size_t ncache_hits;                     /**< Number of answers that came from a ResultCache instead of the solver. */
     };
 
     typedef std::set<uint64_t> Definitions;     /**< Free variables that have been defined. */
 
-    SMTSolver(): debug(NULL) { init(); }
+    /** Cache of satisfiability results.
+     *
+     *  The cache maps a set of expressions (see cache_key()) to whether their conjunction is satisfiable, so that a query
+     *  which has been answered before need not run the solver again.  Only SAT_YES and SAT_NO answers are cached.  A cache can
+     *  be associated with a file, in which case it is loaded from that file when constructed and saved back to it when
+     *  destroyed, so answers persist across runs.  The key is a hash of the expressions, including the names of their
+     *  variables, so a later run benefits only to the extent that it builds the same expressions.
+     *
+     *  A cache can be shared by any number of solvers, including solvers in different threads. */
+    class ResultCache {
+    public:
+        /** Constructs an empty cache that is not associated with a file. */
+        ResultCache(): dirty(false) { init(); }
+
+        /** Constructs a cache associated with a file.  The file need not exist yet. */
+        explicit ResultCache(const std::string &file_name);
+
+        /** Destructor saves the cache to its file, if it has one and it was modified. */
+        ~ResultCache();
+
+        /** Looks up a result.  Returns true and sets @p result if the key is present. */
+        bool lookup(uint64_t key, Satisfiable &result) const;
+
+        /** Inserts a result.  SAT_UNKNOWN results are ignored since they might depend on the solver's resource limits. */
+        void insert(uint64_t key, Satisfiable result);
+
+        /** Adds the results stored in a file.  Returns false if the file cannot be read or is malformed, in which case the
+         *  entries read before the error are kept. */
+        bool load(const std::string &file_name);
+
+        /** Writes all results to a file.  The file is replaced atomically.  Returns false on failure.
+         * @{ */
+        bool save(const std::string &file_name) const;
+        bool save();
+        /** @} */
+
+        /** Name of associated file, or empty. */
+        const std::string& get_file_name() const { return file_name; }
+
+        /** Number of results in the cache. */
+        size_t size() const;
+
+        /** Removes all results. */
+        void clear();
+
+    private:
+        ResultCache(const ResultCache&);                // not copyable
+        ResultCache& operator=(const ResultCache&);
+        void init();
+
+        mutable RTS_mutex_t mutex;                      // protects all following data members
+        std::map<uint64_t, Satisfiable> results;
+        std::string file_name;
+        bool dirty;                                     // modified since loaded or saved?
+    };
+
+    SMTSolver(): debug(NULL), cache(NULL) { init(); }
 
     virtual ~SMTSolver() {}
 
@@ -58,6 +116,45 @@ public:
     virtual Satisfiable satisfiable(std::vector<InsnSemanticsExpr::TreeNodePtr>, const InsnSemanticsExpr::TreeNodePtr&);
     /** @} */
 
+    /** Incremental solving.
+     *
+     *  A solver has a stack of levels, each holding assertions; the stack initially has one empty level. insert() adds an
+     *  assertion to the top level, push() starts a new level, and pop() discards the top level with its assertions. check()
+     *  determines whether all assertions of all levels are satisfiable together.  This base implementation simply passes
+     *  all assertions to satisfiable() on each check(), but solvers that can keep their state between queries (such as Yices
+     *  when linked as a library) only need to give the solver the assertions that changed.
+     * @{ */
+    virtual void push();
+    virtual void pop();
+    virtual void insert(const InsnSemanticsExpr::TreeNodePtr&);
+    virtual Satisfiable check();
+    /** @} */
+
+    /** Number of levels in the assertion stack.  This is at least one. */
+    size_t nlevels() const { return levels.size(); }
+
+    /** Assertions.  Returns the assertions of all levels, bottom level first, or those of the specified level, where level
+     *  zero is the bottom.
+     * @{ */
+    std::vector<InsnSemanticsExpr::TreeNodePtr> assertions() const;
+    const std::vector<InsnSemanticsExpr::TreeNodePtr>& assertions(size_t level) const {
+        ASSERT_require(level < levels.size());
+        return levels[level];
+    }
+    /** @} */
+
+    /** Cache for results.  If a cache is set, satisfiable() and check() answer queries from it when possible and add the
+     *  solver's answers to it.  No evidence is available when an answer comes from the cache.  The cache is not owned by the
+     *  solver and the default is to have none.
+     * @{ */
+    void set_cache(ResultCache *c) { cache = c; }
+    ResultCache* get_cache() const { return cache; }
+    /** @} */
+
+    /** Key for a set of expressions in a ResultCache.  The key combines the expressions' hashes without regard to their
+     *  order or repetition, since neither changes whether the conjunction is satisfiable. */
+    static uint64_t cache_key(const std::vector<InsnSemanticsExpr::TreeNodePtr>&);
+
 
 
     /** Evidence of satisfiability for a bitvector variable.  If an expression is satisfiable, this function will return
@@ -130,6 +227,15 @@ protected:
      *  expression.  This information is parsed by this function and added to a mapping of variable to value. */
     virtual void parse_evidence() {};
 
+    /** Looks up a result in the cache, if any.  Returns true and sets @p result if found, updating statistics. */
+    bool cached_result(uint64_t key, Satisfiable &result);
+
+    /** Adds a result to the cache, if any. */
+    void cache_result(uint64_t key, Satisfiable result) {
+        if (cache)
+            cache->insert(key, result);
+    }
+
     /** Additional output obtained by satisfiable(). */
     std::string output_text;
 
@@ -140,6 +246,8 @@ protected:
 
 private:
     FILE *debug;
+    ResultCache *cache;
+    std::vector<std::vector<InsnSemanticsExpr::TreeNodePtr> > levels;
     void init();
 };
 
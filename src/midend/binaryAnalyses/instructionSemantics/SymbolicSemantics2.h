@@ -463,6 +463,128 @@ public:
     /** @} */
 };
 
+/** Shared-ownership pointer to an indexed symbolic memory state. See documentation for IndexedMemoryState. */
+typedef boost::shared_ptr<class IndexedMemoryState> IndexedMemoryStatePtr;
+
+/** Byte-addressable memory with indexed memory cells.
+ *
+ *  This memory state behaves exactly like MemoryState but does not compare the address being read with the address of every
+ *  memory cell.  The address of each cell is split into a base term and a constant offset: a concrete address has no base and
+ *  its value as the offset, "(add esp_0 0xfffffff8)" has base "esp_0" and offset 0xfffffff8, and any other address is its own
+ *  base with offset zero.  Two addresses with the same base and different offsets can never be equal, so scan() skips those
+ *  cells without consulting the SMT solver.  When no solver is used, an address that is an expression can only alias a
+ *  structurally equivalent address, and a leaf can only alias other leaves, so scan() looks only at the cells with the same
+ *  base and offset, plus the cells whose address is a leaf when the address being scanned is a leaf.  Either way the cells
+ *  that remain are checked in reverse chronological order with the usual may-alias and must-alias predicates, so the result
+ *  is the same as MemoryCellList::scan().
+ *
+ *  The index follows cells being added to the front of the cell list by readMemory() and writeMemory(), and is rebuilt
+ *  after the cell list or its addresses are changed by clear(), traverse(), or the non-const get_cells().  Changing the
+ *  address of a cell by any other means leaves the index out of date. */
+class IndexedMemoryState: public MemoryState {
+    typedef std::pair<size_t/*base ID*/, uint64_t/*offset*/> Key;       // base ID zero means a concrete address
+    typedef std::vector<std::pair<size_t/*sequence*/, BaseSemantics::MemoryCellPtr> > Entries;
+    typedef std::vector<std::pair<TreeNodePtr, size_t/*base ID*/> > Bases;
+
+    mutable size_t nindexed;                                            // number of cells at end of list that are indexed
+    mutable std::map<Key, Entries> cells_by_key;                        // indexed cells by address
+    mutable Entries leaf_cells;                                         // indexed cells whose address is a non-concrete leaf
+    mutable std::map<const BaseSemantics::MemoryCell*, Key> key_of_cell;// address key for each indexed cell
+    mutable std::map<uint64_t/*hash*/, Bases> bases;                    // IDs for base terms
+    mutable size_t nbases;                                              // number of base IDs assigned
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    IndexedMemoryState(const BaseSemantics::MemoryCellPtr &protocell)
+        : MemoryState(protocell), nindexed(0), nbases(0) {}
+
+    IndexedMemoryState(const BaseSemantics::SValuePtr &addrProtoval, const BaseSemantics::SValuePtr &valProtoval)
+        : MemoryState(addrProtoval, valProtoval), nindexed(0), nbases(0) {}
+
+    // The index is not copied since it refers to the other state's cells; it is rebuilt when needed.
+    IndexedMemoryState(const IndexedMemoryState &other)
+        : MemoryState(other), nindexed(0), nbases(0) {}
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Instantiates a new memory state having specified prototypical cells and value. */
+    static IndexedMemoryStatePtr instance(const BaseSemantics::MemoryCellPtr &protocell) {
+        return IndexedMemoryStatePtr(new IndexedMemoryState(protocell));
+    }
+
+    /** Instantiates a new memory state having specified prototypical value.  This constructor uses BaseSemantics::MemoryCell
+     * as the cell type. */
+    static IndexedMemoryStatePtr instance(const BaseSemantics::SValuePtr &addrProtoval,
+                                          const BaseSemantics::SValuePtr &valProtoval) {
+        return IndexedMemoryStatePtr(new IndexedMemoryState(addrProtoval, valProtoval));
+    }
+
+    /** Instantiates a new deep copy of an existing state. */
+    static IndexedMemoryStatePtr instance(const IndexedMemoryStatePtr &other) {
+        return IndexedMemoryStatePtr(new IndexedMemoryState(*other));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Virtual constructors
+public:
+    virtual BaseSemantics::MemoryStatePtr create(const BaseSemantics::SValuePtr &addrProtoval,
+                                                 const BaseSemantics::SValuePtr &valProtoval) const ROSE_OVERRIDE {
+        return instance(addrProtoval, valProtoval);
+    }
+
+    virtual BaseSemantics::MemoryStatePtr create(const BaseSemantics::MemoryCellPtr &protocell) const ROSE_OVERRIDE {
+        return instance(protocell);
+    }
+
+    virtual BaseSemantics::MemoryStatePtr clone() const ROSE_OVERRIDE {
+        return IndexedMemoryStatePtr(new IndexedMemoryState(*this));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Dynamic pointer casts
+public:
+    /** Recasts a base pointer to an indexed symbolic memory state. This is a checked cast that will fail if the specified
+     *  pointer does not have a run-time type that is an IndexedMemoryState or subclass thereof. */
+    static IndexedMemoryStatePtr promote(const BaseSemantics::MemoryStatePtr &x) {
+        IndexedMemoryStatePtr retval = boost::dynamic_pointer_cast<IndexedMemoryState>(x);
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods we inherited
+public:
+    virtual void clear() ROSE_OVERRIDE {
+        MemoryState::clear();
+        invalidate_index();
+    }
+
+    virtual CellList scan(const BaseSemantics::SValuePtr &address, size_t nbits, BaseSemantics::RiscOperators *addrOps,
+                          BaseSemantics::RiscOperators *valOps, bool &short_circuited/*out*/) const ROSE_OVERRIDE;
+
+    virtual void traverse(Visitor &visitor) ROSE_OVERRIDE {
+        invalidate_index();
+        MemoryState::traverse(visitor);
+    }
+
+    virtual const CellList& get_cells() const ROSE_OVERRIDE { return cells; }
+    virtual       CellList& get_cells()       ROSE_OVERRIDE { invalidate_index(); return cells; }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods first declared in this class
+public:
+    /** Discards the index.  The index is rebuilt from the cell list by the next scan(). This must be called by anything that
+     *  changes the address of a cell without going through traverse() or get_cells(). */
+    void invalidate_index() const;
+
+private:
+    void update_index() const;
+    void index_cell(const BaseSemantics::MemoryCellPtr&) const;
+    Key address_key(const TreeNodePtr &address, bool insert) const;
+};
+
 
 
 /******************************************************************************************************************
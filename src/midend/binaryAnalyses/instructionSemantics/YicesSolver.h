@@ -28,7 +28,7 @@ public:
     };
 
     /** Constructor prefers to use the Yices executable interface. See set_linkage(). */
-    YicesSolver(): linkage(LM_NONE), context(NULL) {
+    YicesSolver(): linkage(LM_NONE), context(NULL), ctx_incremental(false) {
         init();
     }
     virtual ~YicesSolver();
@@ -63,6 +63,17 @@ public:
     }
     /** @} */
 
+    /** Incremental solving.  When the link mode is LM_LIBRARY the Yices context holds the assertion stack between calls to
+     *  check(), so each check only gives Yices the assertions inserted since the previous one.  A call to satisfiable()
+     *  needs the context for itself, after which the next check() rebuilds the context from the assertion stack.  See
+     *  SMTSolver::check().
+     * @{ */
+    virtual void push() ROSE_OVERRIDE;
+    virtual void pop() ROSE_OVERRIDE;
+    virtual void insert(const InsnSemanticsExpr::TreeNodePtr&) ROSE_OVERRIDE;
+    virtual Satisfiable check() ROSE_OVERRIDE;
+    /** @} */
+
     virtual InsnSemanticsExpr::TreeNodePtr evidence_for_name(const std::string&) /*overrides*/;
     virtual std::vector<std::string> evidence_names() /*overrides*/;
     virtual void clear_evidence() /*overrides*/;
@@ -106,6 +117,7 @@ private:
     typedef yices_expr (*ShiftAPI)(yices_context, yices_expr, unsigned amount);
 
     yices_context context;
+    void ctx_reset();
     void ctx_define(const InsnSemanticsExpr::TreeNodePtr&, Definitions*);
     void ctx_assert(const InsnSemanticsExpr::TreeNodePtr&);
     yices_expr ctx_expr(const InsnSemanticsExpr::TreeNodePtr&);
@@ -129,6 +141,9 @@ private:
     void *context; /*unused for now*/
 #endif
 
+    bool ctx_incremental;                       /* does the context hold the assertion stack? */
+    Definitions ctx_defns;                      /* variables defined in the context while ctx_incremental is set */
+
 };
 
 } // namespace
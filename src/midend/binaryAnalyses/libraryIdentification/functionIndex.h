@@ -0,0 +1,187 @@
+#ifndef ROSE_LibraryIdentification_FunctionIndex_H
+#define ROSE_LibraryIdentification_FunctionIndex_H
+
+#include <MemoryMap.h>
+#include <sawyer/Optional.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace LibraryIdentification {
+
+/** Fingerprint of a function's normalized opcode bytes.
+ *
+ *  A fingerprint has two parts.  The hash of all the bytes identifies functions that are byte-for-byte identical.  The
+ *  MinHash sketch summarizes the set of overlapping byte n-grams: the fraction of sketch values that two fingerprints
+ *  have in common estimates the fraction of n-grams the two functions share, which is how near matches are found for
+ *  functions that differ by a few instructions (e.g., a library built by another compiler version). */
+struct FunctionFingerprint {
+    /** Number of values in the MinHash sketch. */
+    static const size_t nMinHashes = 32;
+
+    /** Number of consecutive bytes in each n-gram. */
+    static const size_t ngramSize = 4;
+
+    uint64_t hash;                                      /**< Hash of all the bytes. */
+    uint32_t minHashes[nMinHashes];                     /**< MinHash sketch of the n-grams. */
+
+    /** Fingerprint of a function with no bytes. */
+    FunctionFingerprint();
+
+    /** Fingerprint of the specified bytes. */
+    explicit FunctionFingerprint(const SgUnsignedCharList &bytes);
+
+    /** Estimated similarity of two functions, from zero (no n-grams in common) to one. */
+    double similarity(const FunctionFingerprint &other) const;
+};
+
+/** Persistent index of library function fingerprints.
+ *
+ *  An index is built once from a corpus of libraries by a @ref FunctionIndexBuilder and saved to a file.  Opening the file
+ *  maps it read-only into memory, so even a large index opens in constant time and its pages are shared by all processes
+ *  that use it.
+ *
+ *  A lookup first searches for an entry with the same exact hash.  If there is none, it finds the entries whose sketches
+ *  agree with the query's on every value of at least one band (a fixed group of sketch values; this is locality sensitive
+ *  hashing) and returns the most similar one, provided it is at least @ref minimumSimilarity.  Ties go to the entry that
+ *  was inserted first.
+ *
+ *  Lookups don't modify the index, so any number of threads may look up functions concurrently. */
+class FunctionIndex {
+public:
+    /** Errors reading an index file. */
+    class Exception: public std::runtime_error {
+    public:
+        Exception(const std::string &mesg): std::runtime_error(mesg) {}
+    };
+
+    /** Result of a successful lookup. */
+    struct Match {
+        std::string fileName;                           /**< Name of the library that contains the function. */
+        std::string functionName;                       /**< Name of the function. */
+        size_t begin;                                   /**< File offset of the function's first byte. */
+        size_t end;                                     /**< File offset one past the function's last byte. */
+        double similarity;                              /**< Estimated similarity, one for exact matches. */
+        bool exact;                                     /**< True if the exact hashes are equal. */
+        Match(): begin(0), end(0), similarity(0.0), exact(false) {}
+    };
+
+    // Layout of the file; defined in functionIndex.C
+    struct FileHeader;
+    struct FileEntry;
+    struct FileKey;
+
+private:
+    MemoryMap::Buffer::Ptr buffer_;                     // the mapped file, or null
+    const FileEntry *entries_;                          // all entries in insertion order
+    const FileKey *exactKeys_;                          // one per entry, sorted by exact hash
+    const FileKey *bandKeys_;                           // one per entry and band, sorted by band hash
+    const char *strings_;                               // NUL-terminated names referenced by the entries
+    size_t nEntries_, nBandKeys_, stringsSize_;
+    double minimumSimilarity_;
+
+public:
+    /** Creates an index with no entries. */
+    FunctionIndex()
+        : entries_(NULL), exactKeys_(NULL), bandKeys_(NULL), strings_(NULL), nEntries_(0), nBandKeys_(0), stringsSize_(0),
+          minimumSimilarity_(0.7) {}
+
+    /** Opens an index file.  Throws an @ref Exception if the file is not a valid index. */
+    explicit FunctionIndex(const std::string &fileName)
+        : entries_(NULL), exactKeys_(NULL), bandKeys_(NULL), strings_(NULL), nEntries_(0), nBandKeys_(0), stringsSize_(0),
+          minimumSimilarity_(0.7) {
+        open(fileName);
+    }
+
+    /** Opens an index file, replacing the entries of this index.  Throws an @ref Exception if the file is not a valid
+     *  index, in which case this index is left empty. */
+    void open(const std::string &fileName);
+
+    /** Number of entries. */
+    size_t size() const { return nEntries_; }
+
+    /** Entry by position in insertion order.  The similarity of the returned match is one. */
+    Match entry(size_t idx) const;
+
+    /** Fingerprint of an entry by position in insertion order. */
+    FunctionFingerprint fingerprint(size_t idx) const;
+
+    /** Property: Least similarity reported by lookups that don't find an exact match.
+     * @{ */
+    double minimumSimilarity() const { return minimumSimilarity_; }
+    void minimumSimilarity(double d) { minimumSimilarity_ = d; }
+    /** @} */
+
+    /** Looks up one function.  Returns nothing if no entry is an exact match and none is similar enough.
+     * @{ */
+    Sawyer::Optional<Match> lookup(const FunctionFingerprint&) const;
+    Sawyer::Optional<Match> lookup(const SgUnsignedCharList &bytes) const;
+    /** @} */
+
+    /** Looks up many functions in parallel.  Fingerprinting and lookup are both done by @p nThreads threads (zero means one
+     *  per processor), which claim the functions in small batches.  The return value has one element per function. */
+    std::vector<Sawyer::Optional<Match> > lookup(const std::vector<SgUnsignedCharList> &functions, size_t nThreads) const;
+
+private:
+    Match makeMatch(size_t idx, double similarity, bool exact) const;
+    const char *string(uint64_t offset) const;
+};
+
+/** Builds an index file.
+ *
+ *  Functions are added in memory and then written all at once by @ref save. */
+class FunctionIndexBuilder {
+    struct Function {
+        FunctionFingerprint fingerprint;
+        std::string fileName, functionName;
+        size_t begin, end;
+    };
+    std::vector<Function> functions_;
+
+public:
+    /** Number of functions inserted so far. */
+    size_t size() const { return functions_.size(); }
+
+    /** Adds a function.
+     * @{ */
+    void insert(const std::string &fileName, const std::string &functionName, size_t begin, size_t end,
+                const SgUnsignedCharList &bytes);
+    void insert(const std::string &fileName, const std::string &functionName, size_t begin, size_t end,
+                const FunctionFingerprint&);
+    /** @} */
+
+    /** Adds all entries of an existing index, in their original order. */
+    void insert(const FunctionIndex&);
+
+    /** Writes the index to a file.  The file is written under a temporary name and then renamed, so an index that is open
+     *  under the same name remains valid.  Throws a @ref FunctionIndex::Exception on failure. */
+    void save(const std::string &fileName) const;
+};
+
+/** Normalized opcode bytes of a function.
+ *
+ *  Returns the raw bytes of the function's instructions in AST order, with the bits that encode constants (those covered
+ *  by an SgAsmValueExpression's bit offset and size) cleared, so that functions differing only in addresses and immediate
+ *  values have the same bytes.  If @p begin and @p end are non-null they are set to the file offsets of the function's
+ *  lowest and highest instruction address, or to the addresses themselves if @p interp has no memory map that covers
+ *  them. */
+SgUnsignedCharList normalizedFunctionBytes(SgAsmFunction*, SgAsmInterpretation *interp=NULL, size_t *begin=NULL,
+                                           size_t *end=NULL);
+
+/** Adds every non-empty function of every interpretation in @p project to an index file, creating the file if it doesn't
+ *  exist.  The library name recorded for the functions is the project name. */
+void buildFunctionIndex(const std::string &indexName, SgProject *project);
+
+/** Functions that were found in an index, and the index entry that matched each one. */
+typedef std::vector<std::pair<SgAsmFunction*, FunctionIndex::Match> > FunctionMatches;
+
+/** Looks up every non-empty function of an interpretation in an index.  The bytes of all functions are gathered first and
+ *  then looked up in parallel by @p nThreads threads (zero means one per processor).  The matches are returned in AST
+ *  order. */
+FunctionMatches matchFunctionIndex(const FunctionIndex&, SgAsmInterpretation*, size_t nThreads=0);
+
+} // namespace
+
+#endif
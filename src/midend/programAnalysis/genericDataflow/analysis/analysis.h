@@ -26,9 +26,27 @@ class Analysis
     // Custom filter is set inside the intra-procedural analysis.
     // Inter-procedural analysis will copy the filter from its intra-procedural analysis during the call to its constructor.
     bool (*filter) (CFGNode cfgn); 
-    Analysis(bool (*f)(CFGNode) = defaultFilter):filter(f) {}
+
+    // Small integer that identifies this analysis in NodeState's per-analysis tables. Slots are handed out at
+    // construction (a copy gets its own slot) and recycled when the analysis is destroyed, so they stay dense.
+    const size_t stateSlot;
+
+    Analysis(bool (*f)(CFGNode) = defaultFilter):filter(f), stateSlot(allocateStateSlot()) {}
+    Analysis(const Analysis& that):filter(that.filter), stateSlot(allocateStateSlot()) {}
+    ~Analysis() { releaseStateSlot(stateSlot); }
+
+    // Assignment copies the filter but keeps this analysis' own slot
+    Analysis& operator=(const Analysis& that) { filter = that.filter; return *this; }
+
+  private:
+    static size_t allocateStateSlot();
+    static void releaseStateSlot(size_t slot);
 };
 
+// Returns the NodeState slot of the given analysis (declared in nodeState.h, which cannot see Analysis' definition)
+inline size_t analysisStateSlot(const Analysis* analysis)
+{ return analysis->stateSlot; }
+
 class InterProceduralAnalysis;
 
 class IntraProceduralAnalysis : virtual public Analysis
@@ -15,6 +15,8 @@ class NodeState;
 #ifdef THREADED
 #include "tbb/concurrent_hash_map.h"
 #include "tbb/atomic.h"
+#else
+#include <boost/unordered_map.hpp>
 #endif
 
 
@@ -86,6 +88,74 @@ class NodeStateHashCompare
 };
 #endif
 
+#ifndef THREADED
+// Returns the analysis' index into AnalysisSlotMap (defined in analysis.h)
+inline size_t analysisStateSlot(const Analysis* analysis);
+
+// Per-analysis state stored at a NodeState, indexed by the analysis' state slot (see Analysis::stateSlot) so that a
+// lookup is a vector access rather than a search. Supports the subset of std::map<Analysis*,T> used by NodeState:
+// find() returns end() for analyses that have no mapping at this node.
+template<class T>
+class AnalysisSlotMap
+{
+        public:
+        typedef std::pair<Analysis*, T> value_type;
+        typedef typename std::vector<value_type>::iterator iterator;
+        typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+        private:
+        // slots[i].first is the analysis that owns slot i, or NULL if the slot is unmapped
+        std::vector<value_type> slots;
+        size_t nMapped;
+
+        public:
+        AnalysisSlotMap(): nMapped(0) {}
+
+        iterator find(const Analysis* analysis)
+        {
+                size_t i = analysisStateSlot(analysis);
+                return i<slots.size() && slots[i].first==analysis ? slots.begin()+i : slots.end();
+        }
+
+        const_iterator find(const Analysis* analysis) const
+        {
+                size_t i = analysisStateSlot(analysis);
+                return i<slots.size() && slots[i].first==analysis ? slots.begin()+i : slots.end();
+        }
+
+        iterator end() { return slots.end(); }
+        const_iterator end() const { return slots.end(); }
+
+        // returns the analysis' value, creating a default-constructed one if the analysis has no mapping
+        T& operator[](const Analysis* analysis)
+        {
+                size_t i = analysisStateSlot(analysis);
+                if(i>=slots.size())
+                        slots.resize(i+1, value_type((Analysis*)NULL, T()));
+                if(slots[i].first!=analysis) {
+                        if(slots[i].first==NULL)
+                                nMapped++;
+                        slots[i].first = (Analysis*)analysis;
+                        slots[i].second = T();
+                }
+                return slots[i].second;
+        }
+
+        void erase(const Analysis* analysis)
+        {
+                iterator it = find(analysis);
+                if(it!=slots.end()) {
+                        it->first = NULL;
+                        it->second = T();
+                        nMapped--;
+                }
+        }
+
+        // number of analyses that have a mapping
+        size_t size() const { return nMapped; }
+};
+#endif
+
 class NodeState
 {
         #ifdef THREADED
@@ -94,10 +164,10 @@ class NodeState
         typedef tbb::concurrent_hash_map <Analysis*, std::vector<NodeFact*>, NodeStateHashCompare > NodeFactMap;
         typedef tbb::concurrent_hash_map <Analysis*, bool, NodeStateHashCompare  > BoolMap;     
         #else
-        typedef std::map<Analysis*, std::vector<Lattice*> > LatticeMap;
+        typedef AnalysisSlotMap<std::vector<Lattice*> > LatticeMap;
         //typedef std::map<Analysis*, std::map<int, NodeFact*> > NodeFactMap;
-        typedef std::map<Analysis*, std::vector<NodeFact*> > NodeFactMap;
-        typedef std::map<Analysis*, bool > BoolMap;
+        typedef AnalysisSlotMap<std::vector<NodeFact*> > NodeFactMap;
+        typedef AnalysisSlotMap<bool> BoolMap;
         #endif
         
         // the dataflow information Above the node, for each analysis that 
@@ -284,9 +354,19 @@ class NodeState
         
         // ====== STATIC ======
         private:
-        static std::map<DataflowNode, std::vector<NodeState*> > nodeStateMap;
+        // The NodeStates of every dataflow node, stored densely: each SgNode that appears in some function's dataflow
+        // CFG owns a contiguous run of rows in nodeStateTable, one per CFG index, starting at nodeStateBase[sgn].
+        #ifdef THREADED
+        static std::map<SgNode*, size_t> nodeStateBase;
+        #else
+        static boost::unordered_map<SgNode*, size_t> nodeStateBase;
+        #endif
+        static std::vector<std::vector<NodeState*> > nodeStateTable;
         static bool nodeStateMapInit;
         
+        // returns the row of nodeStateTable that holds n's NodeStates, or NULL if n is not in any function's CFG
+        static std::vector<NodeState*>* findNodeStates(const DataflowNode& n);
+        
         public:
         // returns the NodeState object associated with the given dataflow node.
         // index is used when multiple NodeState objects are associated with a given node
@@ -19,6 +19,9 @@
 #include <boost/foreach.hpp>
 #include <filteredCFG.h>
 #include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
 #include "reachingDef.h"
 #include "dataflowCfgFilter.h"
 #include "CallGraph.h"
@@ -53,6 +56,14 @@ namespace ssa_private
         }
     };
 
+    /** Calls work(i) for each i in [0, nItems) using up to nThreads threads, the calling thread being one of them. Zero
+     * threads means one per processor. Items are claimed one at a time, so the order in which they run is unspecified. */
+    void parallelFor(size_t nThreads, size_t nItems, const boost::function<void(size_t)>& work);
+
+    /** Serializes everything that computes mangled names while threads are running (e.g. isVarInScope and the class
+     * hierarchy queries, which look classes up by mangled name), since the AST caches mangled names in a global map. */
+    extern boost::mutex mangledNameMutex;
+
 } //namespace ssa_private
 
 /** Static single assignment analysis.
@@ -88,13 +99,24 @@ public:
     /** A map from each variable to its reaching definitions at the current node. */
     typedef std::map<VarName, ReachingDefPtr> NodeReachingDefTable;
 
+    /** Dense integer ID of a variable name. Each distinct VarName is interned the first time it is seen, so that the
+     * dataflow tables can be keyed by small integers rather than by copying and comparing name vectors. */
+    typedef unsigned VarId;
+
+    /** The reaching definitions at a node, keyed by variable ID and sorted by ID. This is the compact form of
+     * NodeReachingDefTable used during the analysis. */
+    typedef std::vector<std::pair<VarId, ReachingDefPtr> > VarIdReachingDefTable;
+
     /** The first table is the IN table. The second table is the OUT table. */
-    typedef boost::unordered_map<SgNode*, std::pair<NodeReachingDefTable, NodeReachingDefTable> > GlobalReachingDefTable;
+    typedef boost::unordered_map<SgNode*, std::pair<VarIdReachingDefTable, VarIdReachingDefTable> > GlobalReachingDefTable;
 
     /** Map from each node to the variables used at that node and their reaching definitions. */
     typedef boost::unordered_map<SgNode*, NodeReachingDefTable> UseTable;
 
 private:
+    /** The function call sites in a function body, each with the functions it may call. */
+    typedef std::vector<std::pair<SgExpression*, std::vector<SgFunctionDeclaration*> > > CallSiteList;
+
     //Private member variables
 
     /** This is the table of variable definition locations that is generated by
@@ -128,11 +150,24 @@ private:
     /** Local definitions (actual definitions, not phi definitions).
      * This table does not get populated until AFTER interprocedural propagation; hence
      * the values here cannot be used during interprocedural analysis.  */
-    boost::unordered_map<SgNode*, NodeReachingDefTable> ssaLocalDefTable;
+    boost::unordered_map<SgNode*, VarIdReachingDefTable> ssaLocalDefTable;
+
+    /** All the interned variable names, indexed by VarId. */
+    std::vector<VarName> varNamesById;
+
+    /** Map from each interned variable name to its ID. */
+    boost::unordered_map<VarName, VarId> varIdsByName;
+
+    /** Name-keyed copies of the ID-keyed tables, built on demand by the query functions that return a
+     * NodeReachingDefTable reference. */
+    mutable boost::unordered_map<SgNode*, NodeReachingDefTable> outgoingDefsCache, reachingDefsCache, localDefsCache;
+
+    /** Number of threads used to process functions concurrently. Zero means one per processor. */
+    size_t nThreads;
 
 public:
 
-    StaticSingleAssignment(SgProject* proj) : project(proj)
+    StaticSingleAssignment(SgProject* proj) : project(proj), nThreads(1)
     {
     }
 
@@ -146,6 +181,22 @@ public:
      * @param treatPointersAsStructures if true, p->x is versioned as if it were the variable p.x. */
     void run(bool interprocedural, bool treatPointersAsStructures);
 
+    /** Number of threads used by run. The default, one, processes one function at a time in the calling thread. Otherwise
+     * the intraprocedural phases run on that many threads with one function per work item, and the interprocedural
+     * propagation processes independent strongly connected components of the call graph concurrently. Zero means one
+     * thread per processor. The results do not depend on the number of threads.
+     * @{ */
+    size_t getNumberOfThreads() const
+    {
+        return nThreads;
+    }
+
+    void setNumberOfThreads(size_t n)
+    {
+        nThreads = n;
+    }
+    /** @} */
+
     static bool getDebug()
     {
         return SgProject::get_verbose() > 0;
@@ -164,6 +215,31 @@ private:
     /** Returns true if the variable is implicitly defined at the function entry by the compiler. */
     static bool isBuiltinVar(const VarName& var);
 
+    /** Returns the ID of the given variable name, assigning the next unused ID if the name was not seen before. Looking up
+     * a name that is already interned does not modify the tables, so all names are interned before functions are
+     * processed concurrently. */
+    VarId getVarId(const VarName& var);
+
+    /** Returns the variable name that was interned with the given ID. */
+    const VarName& getVarNameById(VarId id) const
+    {
+        return varNamesById[id];
+    }
+
+    /** Returns the definition of a variable in an ID-keyed table, or a null pointer if the variable has none. */
+    static ReachingDefPtr findDef(const VarIdReachingDefTable& table, VarId var);
+
+    /** Sets the definition of a variable in an ID-keyed table, replacing any existing definition. */
+    static void setDef(VarIdReachingDefTable& table, VarId var, const ReachingDefPtr& def);
+
+    /** Returns the name-keyed version of an ID-keyed table, building it in the given cache on first use. */
+    const NodeReachingDefTable& getCachedTable(boost::unordered_map<SgNode*, NodeReachingDefTable>& cache, SgNode* node,
+            const VarIdReachingDefTable* table) const;
+
+    /** Returns the ID-keyed definitions of all the variables right after the given node has executed, or NULL if there
+     * are none. See getOutgoingDefsAtNode. */
+    const VarIdReachingDefTable* findOutgoingDefs(SgNode* node) const;
+
     /** Expand all member definitions (chained names) to define every name in the chain
      * that is shorter than the originally defined name.
      *
@@ -203,6 +279,20 @@ private:
      * they have no uses. */
     void insertDefsForChildMemberUses(SgFunctionDeclaration* function);
 
+    /** Run the DefsAndUsesTraversal on one function and expand its member defs and uses. The results go in the tables of
+     * a new object that is stored in results[i], so functions can be processed concurrently.
+     * @param funcs all the functions being processed; funcs[i] is the one to process. */
+    void collectLocalDefsAndUses(const std::vector<SgFunctionDefinition*>& funcs, bool treatPointersAsStructures,
+            std::vector<StaticSingleAssignment*>& results, size_t i);
+
+    /** Insert phi functions, number the definitions, propagate them and match uses to their reaching definitions for one
+     * function. Every CFG node of the function must already have an entry in the reaching defs table, which is all this
+     * modifies, so functions can be processed concurrently.
+     * @param cfgNodesInPostOrder the CFG nodes of each function, in postorder
+     * @param uses receives the use table of each function; uses[i] is the one for funcs[i]. */
+    void buildFunctionSsa(const std::vector<SgFunctionDefinition*>& funcs,
+            const std::vector<std::vector<FilteredCfgNode> >& cfgNodesInPostOrder, std::vector<UseTable>& uses, size_t i);
+
     /** Insert defs for functions that are declared outside the function scope. */
     void insertDefsForExternalVariables(SgFunctionDeclaration* function);
 
@@ -233,13 +323,18 @@ private:
 
     /** Once all the reaching def information has been propagated, uses the reaching def information and the local
      * use information to match uses to their reaching defs. 
-     * @param cfgNodesInPostOrder all the nodes for which uses should be matched to defs*/
-    void buildUseTable(const std::vector<FilteredCfgNode>& cfgNodes);
+     * @param cfgNodesInPostOrder all the nodes for which uses should be matched to defs
+     * @param uses the table that receives the uses */
+    void buildUseTable(const std::vector<FilteredCfgNode>& cfgNodes, UseTable& uses);
 
     /** Iterates all the CFG nodes in the function and returns them in postorder, according to depth-first search.
      * Reverse postorder is the most efficient order for dataflow propagation. */
     static std::vector<FilteredCfgNode> getCfgNodesInPostorder(SgFunctionDefinition* func);
 
+    /** Stores the CFG nodes of funcs[i] in postorder in cfgNodesInPostOrder[i]. */
+    static void collectCfgNodesInPostorder(const std::vector<SgFunctionDefinition*>& funcs,
+            std::vector<std::vector<FilteredCfgNode> >& cfgNodesInPostOrder, size_t i);
+
     //------------ INTERPROCEDURAL ANALYSIS FUNCTIONS ------------ //
 
     /** Insert definitions at function call sites for all variables defined interprocedurally. Iterates on the
@@ -247,25 +342,33 @@ private:
      * @param interestinFunctions all functions that should be analyzed. */
     void interproceduralDefPropagation(const boost::unordered_set<SgFunctionDefinition*>& interestingFunctions);
 
-    /** This function returns the order in which functions should be processed so that callees are processed before
-     * callers whenever possible (this is sometimes not possible due to recursion). Internally, it builds a call graph
-     * and constructs a depth-first ordering of it. */
-    std::vector<SgFunctionDefinition*> calculateInterproceduralProcessingOrder(
-            const boost::unordered_set<SgFunctionDefinition*>& interestingFunctions);
-
-    /** Add all the callees of the function to the processing list, then add the function itself. Does nothing
-     * if the function is already in the list. */
-    void processCalleesThenFunction(SgFunctionDefinition* targetFunction, SgIncidenceDirectedGraph* callGraph,
-            const boost::unordered_map<SgFunctionDefinition*, SgGraphNode*>& graphNodeToFunction,
-            std::vector<SgFunctionDefinition*> &processingOrder, std::set<SgFunctionDefinition*> visited);
+    /** Partitions the functions into the strongly connected components of their call graph and groups the components
+     * into levels, such that every function a component depends on is in the same component or in a lower level. A
+     * function depends on its callees and on the functions nested inside it. Components in the same level can be
+     * processed concurrently.
+     * @param callSites the call sites of each function
+     * @param recursive receives true for each component that depends on itself
+     * @return the components in each level, starting with the callees. */
+    std::vector<std::vector<std::vector<SgFunctionDefinition*> > > calculateInterproceduralLevels(
+            const boost::unordered_set<SgFunctionDefinition*>& interestingFunctions,
+            const boost::unordered_map<SgFunctionDefinition*, CallSiteList>& callSites,
+            boost::unordered_map<SgFunctionDefinition*, bool>& recursive);
+
+    /** Insert interprocedural defs at the call sites of one strongly connected component of the call graph, iterating
+     * until they converge. All the components it depends on must already be processed.
+     * @param components the components of one level; components[i] is the one to process. */
+    void propagateInterproceduralDefsInComponent(const std::vector<std::vector<SgFunctionDefinition*> >& components,
+            const boost::unordered_map<SgFunctionDefinition*, CallSiteList>& callSites,
+            const boost::unordered_map<SgFunctionDefinition*, bool>& recursive,
+            const boost::unordered_set<SgFunctionDefinition*>& processed, ClassHierarchyWrapper* classHierarchy, size_t i);
 
     /** Add definitions at function call expressions for variables that are modified interprocedurally.
-     * The definitions are inserted in the original def table.
-     * @param funcDef function whose body should be queries for function calls
+     * The definitions are inserted in the original def table, which must already have an entry for each call site.
+     * @param callSites the call sites in the body of the function and their callees
      * @param processed all the functions completely processed by SSA. If a callee is one of these functions,
      *                  we can use exact information.
      * @return true if new defs were inserted, false otherwise. */
-    bool insertInterproceduralDefs(SgFunctionDefinition* funcDef, const boost::unordered_set<SgFunctionDefinition*>& processed,
+    bool insertInterproceduralDefs(const CallSiteList& callSites, const boost::unordered_set<SgFunctionDefinition*>& processed,
             ClassHierarchyWrapper* classHierarchy);
 
     /** Insert the interprocedural defs at a particular call site for a particular callee. This function may be called
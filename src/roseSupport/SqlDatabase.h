@@ -289,7 +289,8 @@ public:
 
     /** Bulk load data into table.  The specified input stream contains comma-separated values which are inserted in bulk
      *  into the specified table.  The number of fields in each row of the input stream must match the number of columns
-     *  in the table. Some drivers require that a bulk load is the only operation performed in a transaction. */
+     *  in the table; an empty field is a null value.  Lines may be of any length.  Some drivers require that a bulk load is
+     *  the only operation performed in a transaction. */
     void bulk_load(const std::string &tablename, std::istream&);
 
     /** Returns the low-level driver name for this transaction. */
@@ -216,6 +216,23 @@ int RTS_mutex_unlock(RTS_mutex_t*);
 
 
 
+/******************************************************************************************************************************
+ *                                      Thread exit functions
+ ******************************************************************************************************************************/
+
+/** Register a function to be called when the calling thread exits.
+ *
+ *  The function is called with the specified argument when the calling thread exits via pthread_exit() or by returning from
+ *  its start routine, in the reverse order of registration.  All functions are registered with a single POSIX thread-specific
+ *  data key, so ROSE uses one key no matter how many components need to clean up per-thread data (PTHREAD_KEYS_MAX is often
+ *  only 1024).  Returns true if the function was registered, and false if it could not be (e.g., the key could not be
+ *  created, or ROSE was compiled without thread support) in which case the caller should not keep per-thread data that would
+ *  need to be cleaned up. */
+bool RTS_at_thread_exit(void(*)(void*), void *arg);
+
+
+
+
 /*******************************************************************************************************************************
  *                                      Paired macros for using RTS_rwlock_t
  *******************************************************************************************************************************/
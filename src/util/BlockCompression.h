@@ -0,0 +1,28 @@
+#ifndef ROSE_BlockCompression_H
+#define ROSE_BlockCompression_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/** Fast lossless compression of independent blocks of memory.
+ *
+ *  The format is a byte-oriented LZ77 variant in the style of LZ4: a sequence of tokens, each of which is a run of literal
+ *  bytes followed by a copy of up to 64kB back in the already decompressed output.  It favors speed over ratio and needs no
+ *  external library.  Each block is self-contained, so blocks can be compressed and decompressed in parallel.  The
+ *  decompressed size is not stored in the block; callers must record it. */
+namespace BlockCompression {
+
+/** Upper bound for the compressed size of @p size bytes. */
+size_t compressBound(size_t size);
+
+/** Compresses @p size bytes at @p data and appends the result to @p out.  Returns the number of bytes appended. */
+size_t compress(const uint8_t *data, size_t size, std::vector<uint8_t> &out/*in,out*/);
+
+/** Decompresses a block of @p size bytes at @p data into exactly @p outSize bytes at @p out.  Returns false if the block is
+ *  corrupt or does not decompress to exactly @p outSize bytes; never reads or writes outside the buffers. */
+bool decompress(const uint8_t *data, size_t size, uint8_t *out, size_t outSize);
+
+} // namespace
+
+#endif
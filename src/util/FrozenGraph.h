@@ -0,0 +1,789 @@
+#ifndef ROSE_FrozenGraph_H
+#define ROSE_FrozenGraph_H
+
+#include <sawyer/Assert.h>
+#include <sawyer/Graph.h>                               // for GraphTraits
+#include <sawyer/Optional.h>                            // for Sawyer::Nothing
+#include <sawyer/Sawyer.h>
+#include <boost/range/iterator_range.hpp>
+#include <iterator>
+#include <vector>
+
+namespace rose {
+
+/** Immutable graph stored in compressed sparse row form.
+ *
+ *  A frozen graph is a read-only snapshot of some other graph, usually a @ref Sawyer::Container::Graph.  It has the same vertex and edge ID
+ *  numbers, the same user-defined values, and the same connectivity as the graph from which it was created, and it has the
+ *  same ID-based API for querying vertices and edges.  What it doesn't have is any way to insert or erase vertices or edges;
+ *  the only way to change its structure is to assign a new snapshot to it.  The user-defined values can still be modified
+ *  through non-const iterators.
+ *
+ *  In exchange for being immutable, the storage is compact and contiguous: vertices are stored in an array indexed by ID,
+ *  edges are stored in an array sorted by source vertex, and the outgoing and incoming edges of each vertex are contiguous
+ *  slices of two edge pointer arrays.  Walking a vertex's edges is therefore a linear scan instead of a traversal of a linked
+ *  list, which makes a frozen graph a better choice than a Sawyer graph for analyses that repeatedly traverse large graphs
+ *  without modifying them.
+ *
+ *  Since the node types, iterator types, and @ref Sawyer::Container::GraphTraits are the same as for a Sawyer graph, generic
+ *  algorithms such as those in sawyer/GraphTraversal.h work with either.  For example:
+ *
+ * @code
+ *  typedef Sawyer::Container::Graph<std::string, double> MyGraph;
+ *  typedef FrozenGraph<std::string, double> MyFrozenGraph;
+ *
+ *  MyGraph graph = ...;
+ *  MyFrozenGraph frozen(graph);                        // or: MyFrozenGraph frozen = freeze(graph);
+ *  typedef Sawyer::Container::Algorithm::DepthFirstForwardGraphTraversal<const MyFrozenGraph> Traversal;
+ *  for (Traversal t(frozen, frozen.findVertex(0), Sawyer::Container::Algorithm::ENTER_VERTEX); t; ++t)
+ *      std::cout <<t.vertex()->value() <<"\n";
+ * @endcode
+ *
+ *  Iterators are invalidated when the graph is assigned a new snapshot or destroyed, and are otherwise stable.  The order of
+ *  the @ref edges list is by ID number, and the order of the @ref VertexNode::outEdges "outEdges" and @ref
+ *  VertexNode::inEdges "inEdges" lists is the same as in the original graph. */
+template<class V = Sawyer::Nothing, class E = Sawyer::Nothing>
+class FrozenGraph {
+public:
+    typedef V VertexValue;                              /**< User-level data associated with vertices. */
+    typedef E EdgeValue;                                /**< User-level data associated with edges. */
+    class VertexNode;                                   /**< All information about a vertex. User info plus connectivity info. */
+    class EdgeNode;                                     /**< All information about an edge. User info plus connectivity info. */
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Iterators
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+    /** Base class for edge iterators.
+     *
+     *  Edge iterators point into a null-terminated array of edge node pointers.  Every edge list (the list of all edges and
+     *  each vertex's lists of incoming and outgoing edges) has its own terminator, so all end iterators compare equal, the
+     *  same as for @ref Sawyer::Container::Graph. */
+    template<class Derived, class Value, class Node>
+    class EdgeBaseIterator: public std::iterator<std::bidirectional_iterator_tag, Value> {
+        EdgeNode* const *pos_;                          // position in a null-terminated edge pointer array
+    protected:
+        friend class FrozenGraph;
+        EdgeBaseIterator(): pos_(NULL) {}
+        EdgeBaseIterator(const EdgeBaseIterator &other): pos_(other.pos_) {}
+        EdgeBaseIterator(EdgeNode* const *pos): pos_(pos) {}
+        Node& dereference() const { return **pos_; }
+    public:
+        /** Assignment. */
+        Derived& operator=(const Derived &other) { pos_ = other.pos_; return *derived(); }
+
+        /** Increment.
+         *
+         *  Causes this iterator to advance to the next node of the edge list.  This method should not be invoked on an
+         *  iterator that points to the end of the list.
+         *
+         * @{ */
+        Derived& operator++() { ++pos_; return *derived(); }
+        Derived operator++(int) { Derived old=*derived(); ++*this; return old; }
+        /** @} */
+
+        /** Decrement.
+         *
+         *  Causes this iterator to advance to the previous node of the edge list.  This method should not be invoked on an
+         *  iterator that points to the beginning of the list.
+         *
+         * @{ */
+        Derived& operator--() { --pos_; return *derived(); }
+        Derived operator--(int) { Derived old=*derived(); --*this; return old; }
+        /** @} */
+
+        /** Equality predicate.
+         *
+         *  Two iterators are equal if they point to the same edge node, or if they are both end iterators.
+         *
+         * @{ */
+        template<class OtherIter> bool operator==(const OtherIter &other) const { return node() == other.node(); }
+        template<class OtherIter> bool operator!=(const OtherIter &other) const { return node() != other.node(); }
+        /** @} */
+
+        /** Iterator comparison. */
+        bool operator<(const EdgeBaseIterator &other) const { return node() < other.node(); }
+
+    private:
+        EdgeNode* node() const { return pos_ ? *pos_ : NULL; }
+        Derived* derived() { return static_cast<Derived*>(this); }
+        const Derived* derived() const { return static_cast<const Derived*>(this); }
+    };
+
+    /** Base class for vertex iterators. */
+    template<class Derived, class Value, class Node>
+    class VertexBaseIterator: public std::iterator<std::bidirectional_iterator_tag, Value> {
+        Node *node_;                                    // position in the vertex array
+    protected:
+        friend class FrozenGraph;
+        VertexBaseIterator(): node_(NULL) {}
+        VertexBaseIterator(const VertexBaseIterator &other): node_(other.node_) {}
+        VertexBaseIterator(Node *node): node_(node) {}
+        Node& dereference() const { return *node_; }
+    public:
+        /** Assignment. */
+        Derived& operator=(const Derived &other) { node_ = other.node_; return *derived(); }
+
+        /** Increment.
+         *
+         *  Causes this iterator to advance to the next vertex.  This method should not be invoked on an iterator that points to
+         *  the end of the list.
+         *
+         * @{ */
+        Derived& operator++() { ++node_; return *derived(); }
+        Derived operator++(int) { Derived old=*derived(); ++*this; return old; }
+        /** @} */
+
+        /** Decrement.
+         *
+         *  Causes this iterator to advance to the previous vertex.  This method should not be invoked on an iterator that
+         *  points to the beginning of the list.
+         *
+         * @{ */
+        Derived& operator--() { --node_; return *derived(); }
+        Derived operator--(int) { Derived old=*derived(); --*this; return old; }
+        /** @} */
+
+        /** Equality predicate.
+         *
+         *  Two iterators are equal if they point to the same vertex node, and unequal otherwise.
+         *
+         * @{ */
+        template<class OtherIter> bool operator==(const OtherIter &other) const { return node_ == other.node_; }
+        template<class OtherIter> bool operator!=(const OtherIter &other) const { return node_ != other.node_; }
+        /** @} */
+
+        /** Iterator comparison. */
+        bool operator<(const VertexBaseIterator &other) const { return node_ < other.node_; }
+
+    private:
+        Derived* derived() { return static_cast<Derived*>(this); }
+        const Derived* derived() const { return static_cast<const Derived*>(this); }
+    };
+
+    /** Bidirectional edge node iterator.
+     *
+     *  Iterates over the edge nodes in a list, returning the node (type @ref EdgeNode) when dereferenced.  An
+     *  EdgeNodeIterator can be implicitly converted to a @ref ConstEdgeNodeIterator, @ref EdgeValueIterator, or @ref
+     *  ConstEdgeValueIterator. */
+    class EdgeNodeIterator: public EdgeBaseIterator<EdgeNodeIterator, EdgeNode, EdgeNode> {
+        typedef                    EdgeBaseIterator<EdgeNodeIterator, EdgeNode, EdgeNode> Super;
+    public:
+        typedef EdgeNode& Reference;
+        typedef EdgeNode* Pointer;
+        EdgeNodeIterator() {}
+        EdgeNodeIterator(const EdgeNodeIterator &other): Super(other) {}
+        EdgeNode& operator*() const { return this->dereference(); }
+        EdgeNode* operator->() const { return &this->dereference(); }
+    private:
+        friend class FrozenGraph;
+        EdgeNodeIterator(EdgeNode* const *pos): Super(pos) {}
+    };
+
+    /** Bidirectional edge node iterator.
+     *
+     *  Iterates over the edge nodes in a list, returning a const reference to the node (type @ref EdgeNode) when
+     *  dereferenced. */
+    class ConstEdgeNodeIterator: public EdgeBaseIterator<ConstEdgeNodeIterator, const EdgeNode, const EdgeNode> {
+        typedef                         EdgeBaseIterator<ConstEdgeNodeIterator, const EdgeNode, const EdgeNode> Super;
+    public:
+        typedef const EdgeNode& Reference;
+        typedef const EdgeNode* Pointer;
+        ConstEdgeNodeIterator() {}
+        ConstEdgeNodeIterator(const ConstEdgeNodeIterator &other): Super(other) {}
+        ConstEdgeNodeIterator(const EdgeNodeIterator &other): Super(other.pos_) {}
+        const EdgeNode& operator*() const { return this->dereference(); }
+        const EdgeNode* operator->() const { return &this->dereference(); }
+    private:
+        friend class FrozenGraph;
+        ConstEdgeNodeIterator(EdgeNode* const *pos): Super(pos) {}
+    };
+
+    /** Bidirectional edge value iterator.
+     *
+     *  Iterates over the edge values in a list, returning the user-defined value (type @ref EdgeValue) when dereferenced.  An
+     *  EdgeValueIterator can be implicitly converted to a @ref ConstEdgeValueIterator. */
+    class EdgeValueIterator: public EdgeBaseIterator<EdgeValueIterator, EdgeValue, EdgeNode> {
+        typedef                     EdgeBaseIterator<EdgeValueIterator, EdgeValue, EdgeNode> Super;
+    public:
+        typedef EdgeValue& Reference;
+        typedef EdgeValue* Pointer;
+        EdgeValueIterator() {}
+        EdgeValueIterator(const EdgeValueIterator &other): Super(other) {}
+        EdgeValueIterator(const EdgeNodeIterator &other): Super(other.pos_) {}
+        EdgeValue& operator*() const { return this->dereference().value(); }
+        EdgeValue* operator->() const { return &this->dereference().value(); }
+    private:
+        friend class FrozenGraph;
+        EdgeValueIterator(EdgeNode* const *pos): Super(pos) {}
+    };
+
+    /** Bidirectional edge value iterator.
+     *
+     *  Iterates over the edge values in a list, returning a const reference to the user-defined value (type @ref EdgeValue)
+     *  when dereferenced. */
+    class ConstEdgeValueIterator: public EdgeBaseIterator<ConstEdgeValueIterator, const EdgeValue, const EdgeNode> {
+        typedef                          EdgeBaseIterator<ConstEdgeValueIterator, const EdgeValue, const EdgeNode> Super;
+    public:
+        typedef const EdgeValue& Reference;
+        typedef const EdgeValue* Pointer;
+        ConstEdgeValueIterator() {}
+        ConstEdgeValueIterator(const ConstEdgeValueIterator &other): Super(other) {}
+        ConstEdgeValueIterator(const EdgeValueIterator &other): Super(other.pos_) {}
+        ConstEdgeValueIterator(const EdgeNodeIterator &other): Super(other.pos_) {}
+        ConstEdgeValueIterator(const ConstEdgeNodeIterator &other): Super(other.pos_) {}
+        const EdgeValue& operator*() const { return this->dereference().value(); }
+        const EdgeValue* operator->() const { return &this->dereference().value(); }
+    private:
+        friend class FrozenGraph;
+        ConstEdgeValueIterator(EdgeNode* const *pos): Super(pos) {}
+    };
+
+    /** Bidirectional vertex node iterator.
+     *
+     *  Iterates over the vertex nodes in ID order, returning the node (type @ref VertexNode) when dereferenced.  A
+     *  VertexNodeIterator can be implicitly converted to a @ref ConstVertexNodeIterator, @ref VertexValueIterator, or @ref
+     *  ConstVertexValueIterator. */
+    class VertexNodeIterator: public VertexBaseIterator<VertexNodeIterator, VertexNode, VertexNode> {
+        typedef                      VertexBaseIterator<VertexNodeIterator, VertexNode, VertexNode> Super;
+    public:
+        typedef VertexNode& Reference;
+        typedef VertexNode* Pointer;
+        VertexNodeIterator() {}
+        VertexNodeIterator(const VertexNodeIterator &other): Super(other) {}
+        VertexNode& operator*() const { return this->dereference(); }
+        VertexNode* operator->() const { return &this->dereference(); }
+    private:
+        friend class FrozenGraph;
+        VertexNodeIterator(VertexNode *node): Super(node) {}
+    };
+
+    /** Bidirectional vertex node iterator.
+     *
+     *  Iterates over the vertex nodes in ID order, returning a const reference to the node (type @ref VertexNode) when
+     *  dereferenced. */
+    class ConstVertexNodeIterator: public VertexBaseIterator<ConstVertexNodeIterator, const VertexNode, const VertexNode> {
+        typedef                           VertexBaseIterator<ConstVertexNodeIterator, const VertexNode, const VertexNode> Super;
+    public:
+        typedef const VertexNode& Reference;
+        typedef const VertexNode* Pointer;
+        ConstVertexNodeIterator() {}
+        ConstVertexNodeIterator(const ConstVertexNodeIterator &other): Super(other) {}
+        ConstVertexNodeIterator(const VertexNodeIterator &other): Super(other.node_) {}
+        const VertexNode& operator*() const { return this->dereference(); }
+        const VertexNode* operator->() const { return &this->dereference(); }
+    private:
+        friend class FrozenGraph;
+        ConstVertexNodeIterator(const VertexNode *node): Super(node) {}
+    };
+
+    /** Bidirectional vertex value iterator.
+     *
+     *  Iterates over the vertex values in ID order, returning the user-defined value (type @ref VertexValue) when
+     *  dereferenced.  A VertexValueIterator can be implicitly converted to a @ref ConstVertexValueIterator. */
+    class VertexValueIterator: public VertexBaseIterator<VertexValueIterator, VertexValue, VertexNode> {
+        typedef                       VertexBaseIterator<VertexValueIterator, VertexValue, VertexNode> Super;
+    public:
+        typedef VertexValue& Reference;
+        typedef VertexValue* Pointer;
+        VertexValueIterator() {}
+        VertexValueIterator(const VertexValueIterator &other): Super(other) {}
+        VertexValueIterator(const VertexNodeIterator &other): Super(other.node_) {}
+        VertexValue& operator*() const { return this->dereference().value(); }
+        VertexValue* operator->() const { return &this->dereference().value(); }
+    private:
+        friend class FrozenGraph;
+        VertexValueIterator(VertexNode *node): Super(node) {}
+    };
+
+    /** Bidirectional vertex value iterator.
+     *
+     *  Iterates over the vertex values in ID order, returning a const reference to the user-defined value (type @ref
+     *  VertexValue) when dereferenced. */
+    class ConstVertexValueIterator: public VertexBaseIterator<ConstVertexValueIterator, const VertexValue,
+                                                              const VertexNode> {
+        typedef                            VertexBaseIterator<ConstVertexValueIterator, const VertexValue,
+                                                              const VertexNode> Super;
+    public:
+        typedef const VertexValue& Reference;
+        typedef const VertexValue* Pointer;
+        ConstVertexValueIterator() {}
+        ConstVertexValueIterator(const ConstVertexValueIterator &other): Super(other) {}
+        ConstVertexValueIterator(const VertexValueIterator &other): Super(other.node_) {}
+        ConstVertexValueIterator(const VertexNodeIterator &other): Super(other.node_) {}
+        ConstVertexValueIterator(const ConstVertexNodeIterator &other): Super(other.node_) {}
+        const VertexValue& operator*() const { return this->dereference().value(); }
+        const VertexValue* operator->() const { return &this->dereference().value(); }
+    private:
+        friend class FrozenGraph;
+        ConstVertexValueIterator(const VertexNode *node): Super(node) {}
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Storage nodes
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+
+    /** Edge node.
+     *
+     *  These nodes contain all information about an edge and are the objects returned (by reference) when an edge node
+     *  iterator (@ref EdgeNodeIterator or @ref ConstEdgeNodeIterator) is dereferenced. */
+    class EdgeNode {
+        size_t id_;                                     // same ID as in the original graph
+        VertexNodeIterator source_, target_;            // starting and ending points of the edge
+        EdgeValue value_;                               // user-defined data for each edge
+    private:
+        friend class FrozenGraph;
+        EdgeNode(size_t id, const VertexNodeIterator &source, const VertexNodeIterator &target, const EdgeValue &value)
+            : id_(id), source_(source), target_(target), value_(value) {}
+    public:
+        /** Unique edge ID number.
+         *
+         *  Edges are numbered consecutively starting at zero, and this is the same ID number the edge had in the graph from
+         *  which this graph was created.
+         *
+         *  Time complexity is constant. */
+        const size_t& id() const { return id_; }
+
+        /** Source vertex.
+         *
+         *  Returns an iterator (pointer) to the vertex that serves as the source of this edge.
+         *
+         *  Time complexity is constant.
+         *
+         * @{ */
+        const VertexNodeIterator& source() { return source_; }
+        ConstVertexNodeIterator source() const { return source_; }
+        /** @} */
+
+        /** Target vertex.
+         *
+         *  Returns an iterator (pointer) to the vertex that serves as the destination of this edge.
+         *
+         *  Time complexity is constant.
+         *
+         * @{ */
+        const VertexNodeIterator& target() { return target_; }
+        ConstVertexNodeIterator target() const { return target_; }
+        /** @} */
+
+        /** User-defined value.
+         *
+         *  Each edge stores one user-defined value whose type is specified as the @p E parameter of the FrozenGraph template
+         *  (a.k.a., the @ref EdgeValue type).  The value was copied from the original graph when this graph was created.
+         *
+         *  Time complexity is constant.
+         *
+         * @{ */
+        EdgeValue& value() { return value_; }
+        const EdgeValue& value() const { return value_; }
+        /** @} */
+
+        /** Determines if edge is a self-edge.
+         *
+         *  Returns true if this edge is a self edge.  A self edge is an edge whose source and target vertices are the same
+         *  vertex. */
+        bool isSelfEdge() const {
+            return source_ == target_;
+        }
+    };
+
+    /** Vertex node.
+     *
+     *  These nodes contain all information about a vertex and are the objects returned (by reference) when a vertex node
+     *  iterator (@ref VertexNodeIterator or @ref ConstVertexNodeIterator) is dereferenced. */
+    class VertexNode {
+        size_t id_;                                     // same ID as in the original graph
+        EdgeNode **outEdges_, **inEdges_;               // null-terminated slices of the graph's edge pointer arrays
+        size_t nOutEdges_, nInEdges_;                   // number of outgoing and incoming edges
+        VertexValue value_;                             // user-defined data for each vertex
+    private:
+        friend class FrozenGraph;
+        VertexNode(size_t id, const VertexValue &value)
+            : id_(id), outEdges_(NULL), inEdges_(NULL), nOutEdges_(0), nInEdges_(0), value_(value) {}
+    public:
+        /** Unique vertex ID number.
+         *
+         *  Vertices are numbered consecutively starting at zero, and this is the same ID number the vertex had in the graph
+         *  from which this graph was created.
+         *
+         *  Time complexity is constant. */
+        const size_t& id() const { return id_; }
+
+        /** List of incoming edges.
+         *
+         *  Returns a pair of edge node iterators that delineate the list of edges whose target is this vertex.
+         *
+         *  Time complexity is constant.
+         *
+         * @{ */
+        boost::iterator_range<EdgeNodeIterator> inEdges() {
+            return boost::iterator_range<EdgeNodeIterator>(EdgeNodeIterator(inEdges_), EdgeNodeIterator(inEdges_+nInEdges_));
+        }
+        boost::iterator_range<ConstEdgeNodeIterator> inEdges() const {
+            return boost::iterator_range<ConstEdgeNodeIterator>(ConstEdgeNodeIterator(inEdges_),
+                                                                ConstEdgeNodeIterator(inEdges_+nInEdges_));
+        }
+        /** @} */
+
+        /** List of outgoing edges.
+         *
+         *  Returns a pair of edge node iterators that delineate the list of edges whose source is this vertex.
+         *
+         *  Time complexity is constant.
+         *
+         * @{ */
+        boost::iterator_range<EdgeNodeIterator> outEdges() {
+            return boost::iterator_range<EdgeNodeIterator>(EdgeNodeIterator(outEdges_),
+                                                           EdgeNodeIterator(outEdges_+nOutEdges_));
+        }
+        boost::iterator_range<ConstEdgeNodeIterator> outEdges() const {
+            return boost::iterator_range<ConstEdgeNodeIterator>(ConstEdgeNodeIterator(outEdges_),
+                                                                ConstEdgeNodeIterator(outEdges_+nOutEdges_));
+        }
+        /** @} */
+
+        /** Number of incoming edges.
+         *
+         *  Returns the in-degree of this vertex, the length of the list returned by @ref inEdges. */
+        size_t nInEdges() const {
+            return nInEdges_;
+        }
+
+        /** Number of outgoing edges.
+         *
+         *  Returns the out-degree of this vertex, the length of the list returned by @ref outEdges. */
+        size_t nOutEdges() const {
+            return nOutEdges_;
+        }
+
+        /** Number of incident edges.
+         *
+         *  Returns the total number of incident edges, the sum of @ref nInEdges and @ref nOutEdges.  Self-edges are counted
+         *  two times: once for the source end, and once for the target end. */
+        size_t degree() const {
+            return nInEdges_ + nOutEdges_;
+        }
+
+        /** User-defined value.
+         *
+         *  Each vertex stores one user-defined value whose type is specified as the @p V parameter of the FrozenGraph template
+         *  (a.k.a., the @ref VertexValue type).  The value was copied from the original graph when this graph was created.
+         *
+         *  Time complexity is constant.
+         *
+         * @{ */
+        VertexValue& value() { return value_; }
+        const VertexValue& value() const { return value_; }
+        /** @} */
+    };
+
+private:
+    // None of these vectors are resized after initialization since nodes and iterators point into them.
+    std::vector<VertexNode> vertices_;                  // all vertices, indexed by ID
+    std::vector<EdgeNode> edges_;                       // all edges, sorted by source vertex
+    std::vector<EdgeNode*> edgesById_;                  // all edges indexed by ID, plus a null terminator
+    std::vector<EdgeNode*> outEdgeLists_;               // out-edges of each vertex, each list followed by a null terminator
+    std::vector<EdgeNode*> inEdgeLists_;                // in-edges of each vertex, each list followed by a null terminator
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Initialization
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+
+    /** Default constructor.
+     *
+     *  Creates an empty graph. */
+    FrozenGraph(): edgesById_(1, NULL) {}
+
+    /** Copy constructor.
+     *
+     *  Initializes this graph by copying all vertices, edges, and connectivity from the @p other graph.  The order of the edge
+     *  lists is preserved.
+     *
+     *  Time complexity is linear in the total number of vertices and edges in @p other. */
+    FrozenGraph(const FrozenGraph &other) {
+        init(other);
+    }
+
+    /** Construct a snapshot of another graph.
+     *
+     *  Initializes this graph by copying all vertices, edges, and connectivity from the @p other graph, which is normally a
+     *  @ref Sawyer::Container::Graph but may be any type with the same ID-based API.  Vertices and edges will have the same ID numbers as in the
+     *  @p other graph, and each vertex's in- and out-edge lists will be in the same order as in @p other.  The values are
+     *  copy-constructed from the source graph's values.
+     *
+     *  Time complexity is linear in the total number of vertices and edges in @p other. */
+    template<class Graph>
+    explicit FrozenGraph(const Graph &other) {
+        init(other);
+    }
+
+    /** Assignment.
+     *
+     *  Causes this graph to be a snapshot of the @p other graph.  All iterators pointing into this graph become invalid.
+     *
+     *  Time complexity is linear in the total number of vertices and edges in both graphs.
+     *
+     * @{ */
+    FrozenGraph& operator=(const FrozenGraph &other) {
+        if (this != &other)
+            init(other);
+        return *this;
+    }
+    template<class Graph>
+    FrozenGraph& operator=(const Graph &other) {
+        init(other);
+        return *this;
+    }
+    /** @} */
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Public methods
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+
+    /** Iterators for all vertices.
+     *
+     *  Returns a pair of vertex node iterators that deliniate the list of all vertices of this graph, in order of their ID
+     *  numbers.
+     *
+     *  Time complexity is constant.
+     *
+     *  @{ */
+    boost::iterator_range<VertexNodeIterator> vertices() {
+        return boost::iterator_range<VertexNodeIterator>(VertexNodeIterator(vertexArray()),
+                                                         VertexNodeIterator(vertexArray()+vertices_.size()));
+    }
+    boost::iterator_range<ConstVertexNodeIterator> vertices() const {
+        return boost::iterator_range<ConstVertexNodeIterator>(ConstVertexNodeIterator(vertexArray()),
+                                                              ConstVertexNodeIterator(vertexArray()+vertices_.size()));
+    }
+    /** @} */
+
+    /** Iterators for all vertices.
+     *
+     *  Returns a pair of vertex value iterators that deliniate the list of all vertices of the graph, in order of their ID
+     *  numbers.
+     *
+     *  Time complexity is constant.
+     *
+     *  @{ */
+    boost::iterator_range<VertexValueIterator> vertexValues() {
+        return boost::iterator_range<VertexValueIterator>(VertexValueIterator(vertexArray()),
+                                                          VertexValueIterator(vertexArray()+vertices_.size()));
+    }
+    boost::iterator_range<ConstVertexValueIterator> vertexValues() const {
+        return boost::iterator_range<ConstVertexValueIterator>(ConstVertexValueIterator(vertexArray()),
+                                                               ConstVertexValueIterator(vertexArray()+vertices_.size()));
+    }
+    /** @} */
+
+    /** Finds the vertex with specified ID number.
+     *
+     *  Returns a vertex node iterator for the vertex with the specified ID.  ID numbers are consecutive integers beginning at
+     *  zero.  Do not call this method with an ID number greater than or equal to the number of vertices contained in this graph.
+     *
+     *  Time complexity is constant.
+     *
+     *  @{ */
+    VertexNodeIterator findVertex(size_t id) {
+        ASSERT_require(id < vertices_.size());
+        return VertexNodeIterator(vertexArray()+id);
+    }
+    ConstVertexNodeIterator findVertex(size_t id) const {
+        ASSERT_require(id < vertices_.size());
+        return ConstVertexNodeIterator(vertexArray()+id);
+    }
+    /** @} */
+
+    /** Determines whether the vertex iterator is valid.
+     *
+     *  Returns true if and only if the specified iterator is not this graph's end iterator and the iterator points to a vertex
+     *  in this graph. */
+    bool isValidVertex(const ConstVertexNodeIterator &vertex) const {
+        return vertex!=vertices().end() && vertex->id()<nVertices() && vertex==findVertex(vertex->id());
+    }
+
+    /** Iterators for all edges.
+     *
+     *  Returns a pair of edge node iterators that deliniate the list of all edges of this graph, in order of their ID numbers.
+     *
+     *  Time complexity is constant.
+     *
+     *  @{ */
+    boost::iterator_range<EdgeNodeIterator> edges() {
+        return boost::iterator_range<EdgeNodeIterator>(EdgeNodeIterator(&edgesById_[0]),
+                                                       EdgeNodeIterator(&edgesById_[0]+edges_.size()));
+    }
+    boost::iterator_range<ConstEdgeNodeIterator> edges() const {
+        return boost::iterator_range<ConstEdgeNodeIterator>(ConstEdgeNodeIterator(&edgesById_[0]),
+                                                            ConstEdgeNodeIterator(&edgesById_[0]+edges_.size()));
+    }
+    /** @} */
+
+    /** Iterators for all edges.
+     *
+     *  Returns a pair of edge value iterators that deliniate the list of all edges of the graph, in order of their ID numbers.
+     *
+     *  Time complexity is constant.
+     *
+     *  @{ */
+    boost::iterator_range<EdgeValueIterator> edgeValues() {
+        return boost::iterator_range<EdgeValueIterator>(EdgeValueIterator(&edgesById_[0]),
+                                                        EdgeValueIterator(&edgesById_[0]+edges_.size()));
+    }
+    boost::iterator_range<ConstEdgeValueIterator> edgeValues() const {
+        return boost::iterator_range<ConstEdgeValueIterator>(ConstEdgeValueIterator(&edgesById_[0]),
+                                                             ConstEdgeValueIterator(&edgesById_[0]+edges_.size()));
+    }
+    /** @} */
+
+    /** Finds the edge with specified ID number.
+     *
+     *  Returns an edge node iterator for the edge with the specified ID.  ID numbers are consecutive integers beginning at
+     *  zero.  Do not call this method with an ID number greater than or equal to the number of edges contained in this graph.
+     *
+     *  Time complexity is constant.
+     *
+     *  @{ */
+    EdgeNodeIterator findEdge(size_t id) {
+        ASSERT_require(id < edges_.size());
+        return EdgeNodeIterator(&edgesById_[id]);
+    }
+    ConstEdgeNodeIterator findEdge(size_t id) const {
+        ASSERT_require(id < edges_.size());
+        return ConstEdgeNodeIterator(&edgesById_[id]);
+    }
+    /** @} */
+
+    /** Determines whether the edge iterator is valid.
+     *
+     *  Returns true if and only if the specified iterator is not this graph's end iterator and the iterator points to an edge
+     *  in this graph. */
+    bool isValidEdge(const ConstEdgeNodeIterator &edge) const {
+        return edge!=edges().end() && edge->id()<nEdges() && edge==findEdge(edge->id());
+    }
+
+    /** Total number of vertices.
+     *
+     *  Returns the total number of vertices in the graph.  Vertex ID numbers are guaranteed to be less than this value and
+     *  greater than or equal to zero.
+     *
+     *  Time complexity is constant. */
+    size_t nVertices() const {
+        return vertices_.size();
+    }
+
+    /** Total number of edges.
+     *
+     *  Returns the total number of edges in the graph.  Edge ID numbers are guaranteed to be less than this value and greater
+     *  than or equal to zero.
+     *
+     *  Time complexity is constant. */
+    size_t nEdges() const {
+        return edges_.size();
+    }
+
+    /** True if graph is empty.
+     *
+     *  Returns true if this graph contains no vertices (and therefore no edges).
+     *
+     *  Time complexity is constant. */
+    bool isEmpty() const {
+        ASSERT_require(edges_.empty() || !vertices_.empty()); // existence of edges implies existence of vertices
+        return vertices_.empty();
+    }
+
+private:
+    VertexNode* vertexArray() {
+        return vertices_.empty() ? NULL : &vertices_[0];
+    }
+    const VertexNode* vertexArray() const {
+        return vertices_.empty() ? NULL : &vertices_[0];
+    }
+
+    // Builds the compressed sparse row representation of another graph.  Edges are stored grouped by source vertex in the
+    // order they appear in each vertex's out-edge list, and the in-edge lists are built in the same order as the original
+    // in-edge lists.
+    template<class Graph>
+    void init(const Graph &other) {
+        typedef typename Sawyer::Container::GraphTraits<const Graph>::VertexNodeIterator OtherVertexIterator;
+        typedef typename Sawyer::Container::GraphTraits<const Graph>::EdgeNodeIterator OtherEdgeIterator;
+        const size_t nv = other.nVertices(), ne = other.nEdges();
+
+        // Copy the old structure before building the new one in case other and *this are the same object.
+        std::vector<VertexNode> vertices;
+        std::vector<EdgeNode> edges;
+        std::vector<size_t> edgeTargets;                // target vertex ID for each edge in edges
+        std::vector<size_t> inEdgeIds;                  // IDs of in-edges for all vertices, grouped by vertex
+        std::vector<size_t> inEdgeCounts(nv, 0);
+        vertices.reserve(nv);
+        edges.reserve(ne);
+        edgeTargets.reserve(ne);
+        inEdgeIds.reserve(ne);
+        for (size_t i=0; i<nv; ++i) {
+            OtherVertexIterator vertex = other.findVertex(i);
+            vertices.push_back(VertexNode(i, vertex->value()));
+            vertices.back().nOutEdges_ = vertex->nOutEdges();
+            for (OtherEdgeIterator edge=vertex->outEdges().begin(); edge!=vertex->outEdges().end(); ++edge) {
+                ASSERT_require(edge->source()->id() == i);
+                edges.push_back(EdgeNode(edge->id(), VertexNodeIterator(), VertexNodeIterator(), edge->value()));
+                edgeTargets.push_back(edge->target()->id());
+            }
+            for (OtherEdgeIterator edge=vertex->inEdges().begin(); edge!=vertex->inEdges().end(); ++edge) {
+                inEdgeIds.push_back(edge->id());
+                ++inEdgeCounts[i];
+            }
+        }
+        ASSERT_require(edges.size() == ne);
+        ASSERT_require(inEdgeIds.size() == ne);
+
+        // Now that no more copying is needed, fill in the pointers.
+        vertices_.swap(vertices);
+        edges_.swap(edges);
+        edgesById_.clear();
+        edgesById_.resize(ne+1, NULL);
+        outEdgeLists_.clear();
+        outEdgeLists_.resize(ne+nv, NULL);
+        inEdgeLists_.clear();
+        inEdgeLists_.resize(ne+nv, NULL);
+        for (size_t i=0, edgeIdx=0, outIdx=0, inIdx=0; i<nv; ++i) {
+            VertexNode &vertex = vertices_[i];
+            vertex.outEdges_ = &outEdgeLists_[outIdx];
+            for (size_t j=0; j<vertex.nOutEdges_; ++j, ++edgeIdx) {
+                EdgeNode &edge = edges_[edgeIdx];
+                edge.source_ = VertexNodeIterator(&vertex);
+                edge.target_ = VertexNodeIterator(&vertices_[edgeTargets[edgeIdx]]);
+                ASSERT_require(edge.id_ < ne && edgesById_[edge.id_] == NULL);
+                edgesById_[edge.id_] = &edge;
+                outEdgeLists_[outIdx++] = &edge;
+            }
+            ++outIdx;                                   // null terminator
+            vertex.inEdges_ = &inEdgeLists_[inIdx];
+            vertex.nInEdges_ = inEdgeCounts[i];
+            inIdx += vertex.nInEdges_ + 1;              // filled below, once all edges have been numbered
+        }
+        for (size_t i=0, inIdx=0; i<nv; ++i) {
+            VertexNode &vertex = vertices_[i];
+            for (size_t j=0; j<vertex.nInEdges_; ++j, ++inIdx)
+                vertex.inEdges_[j] = edgesById_[inEdgeIds[inIdx]];
+        }
+    }
+};
+
+/** Create a frozen snapshot of a graph.
+ *
+ *  Returns a @ref FrozenGraph having the same vertices, edges, ID numbers, and values as the specified graph.  The snapshot is
+ *  independent of the original graph; subsequent changes to either are not reflected in the other. */
+template<class V, class E, class Alloc>
+FrozenGraph<V, E> freeze(const Sawyer::Container::Graph<V, E, Alloc> &graph) {
+    return FrozenGraph<V, E>(graph);
+}
+
+} // namespace
+
+#endif